@@ -9,8 +9,11 @@ uniform mat4 matProjection;
 uniform mat4 matModelView;
 
 #ifdef OGL33C
+    layout(location = 3) in float inLayer;
+
     out vec4 vertColor;
     out vec3 vertTexCoords;
+    flat out float vertLayer;
 #else
     varying vec4 vertColor;
     varying vec3 vertTexCoords;
@@ -20,6 +23,9 @@ void main(void) {
     gl_Position = matProjection * matModelView * vec4(inPosition, 1);
     vertColor = inColor / 255.0;
     vertTexCoords = inTexCoords;
+#ifdef OGL33C
+    vertLayer = inLayer;
+#endif
 }
 
 #else
@@ -40,7 +46,11 @@ uniform float brightnessMultiplier;
 
     in vec4 vertColor;
     in vec3 vertTexCoords;
+    flat in float vertLayer;
     out vec4 OUTCOLOR;
+
+    uniform sampler2DArray texArray;
+    uniform bool textureArrayEnabled;
 #else
     #define OUTCOLOR gl_FragColor
     #define TEXTURESIZE textureSize2D
@@ -55,6 +65,22 @@ void main(void) {
     OUTCOLOR = vertColor;
 
     if (texturingEnabled) {
+        vec4 texColor;
+#ifdef OGL33C
+        if (textureArrayEnabled) {
+            if (alphaPointDiscard && smoothingEnabled) {
+                // do not use smoothing for chroma key
+                ivec2 size = textureSize(texArray, 0).xy;
+                int tx = int((vertTexCoords.x / vertTexCoords.z) * size.x) % size.x;
+                int ty = int((vertTexCoords.y / vertTexCoords.z) * size.y) % size.y;
+                vec4 texel = texelFetch(texArray, ivec3(tx, ty, int(vertLayer)), 0);
+                if (texel.a == 0.0) {
+                    discard;
+                }
+            }
+            texColor = texture(texArray, vec3(vertTexCoords.xy / vertTexCoords.z, vertLayer));
+        } else {
+#endif
 #if defined(GL_EXT_gpu_shader4) || defined(OGL33C)
         if (alphaPointDiscard && smoothingEnabled) {
             // do not use smoothing for chroma key
@@ -68,7 +94,11 @@ void main(void) {
         }
 #endif
 
-        vec4 texColor = TEXTURE(tex0, vertTexCoords.xy / vertTexCoords.z);
+        texColor = TEXTURE(tex0, vertTexCoords.xy / vertTexCoords.z);
+#ifdef OGL33C
+        }
+#endif
+
         if (alphaThreshold >= 0.0 && texColor.a <= alphaThreshold) {
             discard;
         }
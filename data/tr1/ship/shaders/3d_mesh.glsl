@@ -0,0 +1,84 @@
+// Static geometry, transformed, projected and lit on the GPU.
+// Only used with the OpenGL 3.3 backend.
+
+#ifdef VERTEX
+// Vertex shader
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inTexCoords;
+layout(location = 2) in float inLayer;
+layout(location = 3) in float inShade;
+
+uniform mat4 matProjection;
+uniform mat4 matView;
+uniform vec3 projection; // center x, center y, perspective distance
+uniform vec3 depth; // base, scale, near z
+uniform float farZ; // zero to keep distant geometry
+uniform vec4 clipRect; // min x, min y, max x, max y
+uniform vec3 fog; // begin, end, max shade
+uniform vec3 lightColor;
+uniform bool snapUVs;
+
+out vec4 vertColor;
+out vec2 vertTexCoords;
+flat out float vertLayer;
+
+void main(void) {
+    vec4 view = matView * vec4(inPosition, 1.0);
+
+    // Project like the software pipeline, but keep the result multiplied
+    // by z so that clipping happens in homogeneous space.
+    vec2 screen = projection.xy * view.z + view.xy * projection.z;
+    gl_Position = matProjection
+        * vec4(screen, depth.x * view.z - depth.y, view.z);
+
+    gl_ClipDistance[0] = view.z - depth.z;
+    gl_ClipDistance[1] = screen.x - clipRect.x * view.z;
+    gl_ClipDistance[2] = screen.y - clipRect.y * view.z;
+    gl_ClipDistance[3] = clipRect.z * view.z - screen.x;
+    gl_ClipDistance[4] = clipRect.w * view.z - screen.y;
+    gl_ClipDistance[5] = farZ > 0.0 ? farZ - view.z : 1.0;
+
+    float fogShade = clamp((view.z - fog.x) / (fog.y - fog.x), 0.0, 1.0) * fog.z;
+    float shade = clamp(inShade + fogShade, 0.0, fog.z);
+    vertColor = vec4(lightColor * (fog.z + 1.0 - shade) / 255.0, 1.0);
+
+    vec2 uv = snapUVs ? floor(inTexCoords / 256.0) * 256.0 + 127.0 : inTexCoords;
+    vertTexCoords = uv / 65536.0;
+    vertLayer = inLayer;
+}
+
+#else
+// Fragment shader
+
+uniform sampler2DArray texArray;
+uniform bool smoothingEnabled;
+uniform bool alphaPointDiscard;
+uniform float alphaThreshold;
+uniform float brightnessMultiplier;
+
+in vec4 vertColor;
+in vec2 vertTexCoords;
+flat in float vertLayer;
+out vec4 outColor;
+
+void main(void) {
+    if (alphaPointDiscard && smoothingEnabled) {
+        // do not use smoothing for chroma key
+        ivec2 size = textureSize(texArray, 0).xy;
+        int tx = int(vertTexCoords.x * size.x) % size.x;
+        int ty = int(vertTexCoords.y * size.y) % size.y;
+        vec4 texel = texelFetch(texArray, ivec3(tx, ty, int(vertLayer)), 0);
+        if (texel.a == 0.0) {
+            discard;
+        }
+    }
+
+    vec4 texColor = texture(texArray, vec3(vertTexCoords, vertLayer));
+    if (alphaThreshold >= 0.0 && texColor.a <= alphaThreshold) {
+        discard;
+    }
+
+    outColor = vec4(vertColor.rgb * texColor.rgb * brightnessMultiplier, texColor.a);
+}
+#endif // VERTEX
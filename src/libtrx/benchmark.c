@@ -1,9 +1,69 @@
 #include "benchmark.h"
 
+#include "filesystem.h"
+#include "json.h"
 #include "log.h"
 #include "memory.h"
+#include "strings.h"
+#include "utils.h"
 
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_thread.h>
 #include <SDL2/SDL_timer.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define M_MAX_DEPTH 32
+
+typedef struct {
+    BENCHMARK_ZONE zone;
+    Uint64 start;
+} M_OPEN_ZONE;
+
+typedef struct {
+    bool has_parent;
+    BENCHMARK_ZONE parent;
+    Uint64 frame_ticks;
+    int32_t frame_calls;
+    float samples[BENCHMARK_MAX_FRAMES];
+    uint16_t calls[BENCHMARK_MAX_FRAMES];
+} M_ZONE;
+
+static const char *const m_ZoneNames[BENCHMARK_ZONE_NUMBER_OF] = {
+    [BENCHMARK_ZONE_FRAME] = "frame",
+    [BENCHMARK_ZONE_CONTROL] = "control",
+    [BENCHMARK_ZONE_ITEM_CONTROL] = "item_control",
+    [BENCHMARK_ZONE_DRAW] = "draw",
+    [BENCHMARK_ZONE_DRAW_ROOMS] = "draw_rooms",
+    [BENCHMARK_ZONE_SORT_POLY_LIST] = "sort_poly_list",
+    [BENCHMARK_ZONE_DRAW_POLY_LIST] = "draw_poly_list",
+    [BENCHMARK_ZONE_AUDIO_MIX] = "audio_mix",
+};
+
+static bool m_Profiling = false;
+static SDL_threadID m_MainThread = 0;
+static SDL_SpinLock m_Lock = 0;
+static Uint64 m_FrameStart = 0;
+static int32_t m_FrameHead = 0;
+static int32_t m_FrameCount = 0;
+static int32_t m_TotalFrameCount = 0;
+static M_ZONE m_Zones[BENCHMARK_ZONE_NUMBER_OF] = {};
+
+// Every thread (main loop, audio callback) keeps its own zone stack.
+static _Thread_local int32_t m_StackSize = 0;
+static _Thread_local M_OPEN_ZONE m_Stack[M_MAX_DEPTH];
+static _Thread_local int32_t m_ZoneDepth[BENCHMARK_ZONE_NUMBER_OF];
+// scratch space for sorting the samples of a zone
+static _Thread_local float m_SortedSamples[BENCHMARK_MAX_FRAMES];
+
+static int M_CompareFloats(const void *a, const void *b);
+static void M_CommitZone(BENCHMARK_ZONE zone, Uint64 ticks);
+static JSON_OBJECT *M_DumpZoneToJSON(
+    BENCHMARK_ZONE zone, const BENCHMARK_ZONE_STATS *stats);
+static bool M_DumpJSON(const char *path);
+static bool M_DumpCSV(const char *path);
 
 static void M_Log(
     BENCHMARK *const b, const char *file, int32_t line, const char *func,
@@ -60,3 +120,278 @@ void Benchmark_End_Impl(
     Benchmark_Tick_Impl(b, file, line, func, message);
     Memory_FreePointer(&b);
 }
+
+static int M_CompareFloats(const void *const a, const void *const b)
+{
+    const float fa = *(const float *)a;
+    const float fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+static void M_CommitZone(const BENCHMARK_ZONE zone, const Uint64 ticks)
+{
+    SDL_AtomicLock(&m_Lock);
+    m_Zones[zone].frame_ticks += ticks;
+    m_Zones[zone].frame_calls++;
+    SDL_AtomicUnlock(&m_Lock);
+}
+
+static JSON_OBJECT *M_DumpZoneToJSON(
+    const BENCHMARK_ZONE zone, const BENCHMARK_ZONE_STATS *const stats)
+{
+    JSON_OBJECT *const zone_obj = JSON_ObjectNew();
+    JSON_ObjectAppendString(zone_obj, "name", Benchmark_GetZoneName(zone));
+    if (stats->parent != nullptr) {
+        JSON_ObjectAppendString(zone_obj, "parent", stats->parent);
+    }
+    JSON_ObjectAppendInt(zone_obj, "frames", stats->frames);
+    JSON_ObjectAppendDouble(zone_obj, "calls", stats->calls);
+    JSON_ObjectAppendDouble(zone_obj, "min", stats->min);
+    JSON_ObjectAppendDouble(zone_obj, "avg", stats->avg);
+    JSON_ObjectAppendDouble(zone_obj, "p99", stats->p99);
+    JSON_ObjectAppendDouble(zone_obj, "max", stats->max);
+    return zone_obj;
+}
+
+static bool M_DumpJSON(const char *const path)
+{
+    JSON_OBJECT *const root_obj = JSON_ObjectNew();
+    JSON_ObjectAppendInt(root_obj, "frames", m_FrameCount);
+
+    JSON_ARRAY *const zones_arr = JSON_ArrayNew();
+    for (int32_t i = 0; i < BENCHMARK_ZONE_NUMBER_OF; i++) {
+        BENCHMARK_ZONE_STATS stats;
+        if (Benchmark_GetZoneStats(i, &stats)) {
+            JSON_ArrayAppendObject(zones_arr, M_DumpZoneToJSON(i, &stats));
+        }
+    }
+    JSON_ObjectAppendArray(root_obj, "zones", zones_arr);
+
+    JSON_VALUE *const root = JSON_ValueFromObject(root_obj);
+    size_t size;
+    char *const data = JSON_WritePretty(root, "  ", "\n", &size);
+    JSON_ValueFree(root);
+
+    MYFILE *const fp = File_Open(path, FILE_OPEN_WRITE);
+    if (fp != nullptr) {
+        File_WriteData(fp, data, strlen(data));
+        File_Close(fp);
+    }
+    Memory_Free(data);
+    return fp != nullptr;
+}
+
+static bool M_DumpCSV(const char *const path)
+{
+    MYFILE *const fp = File_Open(path, FILE_OPEN_WRITE);
+    if (fp == nullptr) {
+        return false;
+    }
+
+    char line[256];
+    snprintf(line, sizeof(line), "name,parent,frames,calls,min,avg,p99,max\n");
+    File_WriteData(fp, line, strlen(line));
+
+    for (int32_t i = 0; i < BENCHMARK_ZONE_NUMBER_OF; i++) {
+        BENCHMARK_ZONE_STATS stats;
+        if (!Benchmark_GetZoneStats(i, &stats)) {
+            continue;
+        }
+        snprintf(
+            line, sizeof(line), "%s,%s,%d,%.2f,%.3f,%.3f,%.3f,%.3f\n",
+            Benchmark_GetZoneName(i),
+            stats.parent != nullptr ? stats.parent : "",
+            stats.frames, stats.calls, stats.min, stats.avg, stats.p99,
+            stats.max);
+        File_WriteData(fp, line, strlen(line));
+    }
+
+    File_Close(fp);
+    return true;
+}
+
+void Benchmark_SetProfiling(const bool enable)
+{
+    if (enable && !m_Profiling) {
+        Benchmark_ResetZones();
+        m_MainThread = SDL_ThreadID();
+    }
+    m_Profiling = enable;
+}
+
+bool Benchmark_IsProfiling(void)
+{
+    return m_Profiling;
+}
+
+void Benchmark_ResetZones(void)
+{
+    SDL_AtomicLock(&m_Lock);
+    for (int32_t i = 0; i < BENCHMARK_ZONE_NUMBER_OF; i++) {
+        m_Zones[i].has_parent = false;
+        m_Zones[i].frame_ticks = 0;
+        m_Zones[i].frame_calls = 0;
+    }
+    m_FrameHead = 0;
+    m_FrameCount = 0;
+    m_TotalFrameCount = 0;
+    m_FrameStart = SDL_GetPerformanceCounter();
+    SDL_AtomicUnlock(&m_Lock);
+}
+
+void Benchmark_BeginFrame(void)
+{
+    if (!m_Profiling) {
+        return;
+    }
+    m_FrameStart = SDL_GetPerformanceCounter();
+}
+
+void Benchmark_EndFrame(void)
+{
+    if (!m_Profiling) {
+        return;
+    }
+
+    const Uint64 now = SDL_GetPerformanceCounter();
+    const double freq = (double)SDL_GetPerformanceFrequency();
+
+    SDL_AtomicLock(&m_Lock);
+    M_ZONE *const frame = &m_Zones[BENCHMARK_ZONE_FRAME];
+    frame->frame_ticks += now - m_FrameStart;
+    frame->frame_calls++;
+
+    for (int32_t i = 0; i < BENCHMARK_ZONE_NUMBER_OF; i++) {
+        M_ZONE *const zone = &m_Zones[i];
+        zone->samples[m_FrameHead] = zone->frame_ticks * 1000.0 / freq;
+        zone->calls[m_FrameHead] = MIN(zone->frame_calls, UINT16_MAX);
+        zone->frame_ticks = 0;
+        zone->frame_calls = 0;
+    }
+    m_FrameHead = (m_FrameHead + 1) % BENCHMARK_MAX_FRAMES;
+    m_FrameCount = MIN(m_FrameCount + 1, BENCHMARK_MAX_FRAMES);
+    m_TotalFrameCount++;
+    SDL_AtomicUnlock(&m_Lock);
+
+    m_FrameStart = now;
+}
+
+int32_t Benchmark_GetFrameCount(void)
+{
+    return m_TotalFrameCount;
+}
+
+void Benchmark_BeginZone(const BENCHMARK_ZONE zone)
+{
+    if (!m_Profiling || m_StackSize >= M_MAX_DEPTH) {
+        return;
+    }
+
+    M_ZONE *const data = &m_Zones[zone];
+    SDL_AtomicLock(&m_Lock);
+    if (!data->has_parent) {
+        if (m_StackSize > 0) {
+            data->parent = m_Stack[m_StackSize - 1].zone;
+            data->has_parent = data->parent != zone;
+        } else if (zone != BENCHMARK_ZONE_FRAME) {
+            // zones opened outside of any other zone on the main thread are
+            // part of the frame; other threads have their own roots
+            data->parent = BENCHMARK_ZONE_FRAME;
+            data->has_parent = SDL_ThreadID() == m_MainThread;
+        }
+    }
+    SDL_AtomicUnlock(&m_Lock);
+
+    m_Stack[m_StackSize++] = (M_OPEN_ZONE) {
+        .zone = zone,
+        .start = SDL_GetPerformanceCounter(),
+    };
+    m_ZoneDepth[zone]++;
+}
+
+void Benchmark_EndZone(const BENCHMARK_ZONE zone)
+{
+    // profiling may have been toggled while the zone was open
+    if (m_StackSize <= 0 || m_Stack[m_StackSize - 1].zone != zone) {
+        return;
+    }
+
+    const M_OPEN_ZONE *const open_zone = &m_Stack[--m_StackSize];
+    m_ZoneDepth[zone]--;
+
+    // only count the outermost entry of recursively nested zones
+    if (m_Profiling && m_ZoneDepth[zone] == 0) {
+        M_CommitZone(zone, SDL_GetPerformanceCounter() - open_zone->start);
+    }
+}
+
+const char *Benchmark_GetZoneName(const BENCHMARK_ZONE zone)
+{
+    if (zone < 0 || zone >= BENCHMARK_ZONE_NUMBER_OF) {
+        return nullptr;
+    }
+    return m_ZoneNames[zone];
+}
+
+bool Benchmark_GetZoneStats(
+    const BENCHMARK_ZONE zone, BENCHMARK_ZONE_STATS *const stats)
+{
+    if (zone < 0 || zone >= BENCHMARK_ZONE_NUMBER_OF) {
+        return false;
+    }
+
+    float *const samples = m_SortedSamples;
+    const M_ZONE *const data = &m_Zones[zone];
+    const char *parent = nullptr;
+    int32_t count = 0;
+    int32_t calls = 0;
+    double total = 0.0;
+
+    SDL_AtomicLock(&m_Lock);
+    if (data->has_parent) {
+        parent = Benchmark_GetZoneName(data->parent);
+    }
+    for (int32_t i = 0; i < m_FrameCount; i++) {
+        if (data->calls[i] == 0) {
+            continue;
+        }
+        samples[count++] = data->samples[i];
+        calls += data->calls[i];
+        total += data->samples[i];
+    }
+    SDL_AtomicUnlock(&m_Lock);
+
+    if (count > 0) {
+        qsort(samples, count, sizeof(float), M_CompareFloats);
+        const int32_t p99_idx = (int32_t)ceil(count * 0.99) - 1;
+        *stats = (BENCHMARK_ZONE_STATS) {
+            .parent = parent,
+            .frames = count,
+            .calls = (double)calls / count,
+            .min = samples[0],
+            .avg = total / count,
+            .p99 = samples[MAX(p99_idx, 0)],
+            .max = samples[count - 1],
+        };
+    }
+
+    return count > 0;
+}
+
+bool Benchmark_DumpZones(const char *const path)
+{
+    bool result;
+    if (String_EndsWith(path, ".csv")) {
+        result = M_DumpCSV(path);
+    } else {
+        result = M_DumpJSON(path);
+    }
+
+    if (result) {
+        LOG_INFO(
+            "Dumped %d frames of profiling data to %s", m_FrameCount, path);
+    } else {
+        LOG_ERROR("Failed to write profiling data to %s", path);
+    }
+    return result;
+}
@@ -113,6 +113,10 @@ static char *M_WriteToJSON(
     void (*dump)(JSON_OBJECT *root_obj), const char *const old_data,
     const char *const enf_data)
 {
+    // The whole tree is thrown away once written, so build it in an arena.
+    MEMORY_ARENA_ALLOCATOR arena = { .default_chunk_size = 64 * 1024 };
+    JSON_ArenaBegin(&arena);
+
     JSON_OBJECT *root_obj = JSON_ObjectNew();
 
     dump(root_obj);
@@ -122,11 +126,14 @@ static char *M_WriteToJSON(
     M_PreserveEnforcedState(root_obj, old_root, enf_root);
 
     JSON_VALUE *root = JSON_ValueFromObject(root_obj);
+    JSON_ArenaEnd();
+
     size_t size;
     char *data = JSON_WritePretty(root, "  ", "\n", &size);
     JSON_ValueFree(root);
     JSON_ValueFree(old_root);
     JSON_ValueFree(enf_root);
+    Memory_ArenaFree(&arena);
 
     return data;
 }
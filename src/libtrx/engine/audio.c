@@ -10,6 +10,7 @@
 #include <string.h>
 
 SDL_AudioDeviceID g_AudioDeviceID = 0;
+static bool m_IsDisabled = false;
 static int32_t m_RefCount = 0;
 static size_t m_MixBufferCapacity = 0;
 static float *m_MixBuffer = nullptr;
@@ -33,6 +34,11 @@ bool Audio_Init(void)
         return true;
     }
 
+    if (m_IsDisabled) {
+        LOG_INFO("Audio is disabled");
+        return false;
+    }
+
     int32_t result = SDL_Init(SDL_INIT_AUDIO);
     if (result < 0) {
         LOG_ERROR("Error while calling SDL_Init: 0x%lx", result);
@@ -90,6 +96,11 @@ bool Audio_Shutdown(void)
     return true;
 }
 
+void Audio_Disable(void)
+{
+    m_IsDisabled = true;
+}
+
 int32_t Audio_GetAVChannelLayout(const int32_t channels)
 {
     switch (channels) {
@@ -1,8 +1,12 @@
 #include "audio_internal.h"
 
+#include "benchmark.h"
 #include "debug.h"
+#include "filesystem.h"
 #include "log.h"
 #include "memory.h"
+#include "thread_pool.h"
+#include "utils.h"
 
 #include <SDL2/SDL_audio.h>
 #include <errno.h>
@@ -23,12 +27,29 @@
 #include <string.h>
 #include <time.h>
 
+// sound positions are kept in fixed point with this many fractional bits
+#define M_PHASE_BITS 16
+#define M_PHASE_ONE (1 << M_PHASE_BITS)
+#define M_MIX_CHUNK_FRAMES 128
+#define M_MIX_VEC_SIZE 8
+
+// decoded samples are cached on disk, keyed by a hash of the source data
+#define M_CACHE_DIR "cache"
+#define M_CACHE_MAGIC 0x41535254 // TRSA
+#define M_CACHE_VERSION 1
+#define M_CACHE_HEADER_SIZE 24
+#define M_FNV_OFFSET 0xCBF29CE484222325ULL
+#define M_FNV_PRIME 0x100000001B3ULL
+
+typedef float M_MIX_VEC
+    __attribute__((vector_size(M_MIX_VEC_SIZE * sizeof(float))));
+
 typedef struct {
     char *original_data;
     size_t original_size;
 
+    // decoded and downmixed to mono at the working rate
     float *sample_data;
-    int32_t channels;
     int32_t num_samples;
 } AUDIO_SAMPLE;
 
@@ -43,8 +64,9 @@ typedef struct {
     int32_t volume; // volume specified in hundredths of decibel
     int32_t pan; // pan specified in hundredths of decibel
 
-    // pitch shift means the same samples can be reused twice, hence float
-    float current_sample;
+    // pitch shift means the same samples can be reused twice, hence the
+    // fractional part
+    int64_t position;
 
     AUDIO_SAMPLE *sample;
 } AUDIO_SAMPLE_SOUND;
@@ -59,12 +81,24 @@ typedef struct {
 static int32_t m_LoadedSamplesCount = 0;
 static AUDIO_SAMPLE m_LoadedSamples[AUDIO_MAX_SAMPLES] = {};
 static AUDIO_SAMPLE_SOUND m_Samples[AUDIO_MAX_ACTIVE_SAMPLES] = {};
+static int32_t m_ActiveSoundCount = 0;
+static int32_t m_ActiveSounds[AUDIO_MAX_ACTIVE_SAMPLES] = {};
+static THREAD_POOL *m_ThreadPool = nullptr;
 
 static double M_DecibelToMultiplier(double db_gain);
 static bool M_RecalculateChannelVolumes(int32_t sound_id);
 static int32_t M_ReadAVBuffer(void *opaque, uint8_t *dst, int32_t dst_size);
 static int64_t M_SeekAVBuffer(void *opaque, int64_t offset, int32_t whence);
+static uint64_t M_HashData(const char *data, size_t size);
+static char *M_GetCachePath(uint64_t hash);
+static bool M_LoadCached(AUDIO_SAMPLE *sample, uint64_t hash);
+static void M_SaveCached(const AUDIO_SAMPLE *sample, uint64_t hash);
 static bool M_Convert(const int32_t sample_id);
+static void M_ConvertTask(void *arg, int32_t task_idx);
+static int32_t M_FindDuplicate(int32_t sample_id);
+static bool M_Resample(AUDIO_SAMPLE_SOUND *sound, float *dst, int32_t frames);
+static bool M_MixSound(
+    AUDIO_SAMPLE_SOUND *sound, float *dst_buffer, int32_t frames);
 
 static double M_DecibelToMultiplier(double db_gain)
 {
@@ -135,6 +169,88 @@ static int64_t M_SeekAVBuffer(void *opaque, int64_t offset, int32_t whence)
     return src->ptr - src->data;
 }
 
+static uint64_t M_HashData(const char *const data, const size_t size)
+{
+    uint64_t hash = M_FNV_OFFSET;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= (uint8_t)data[i];
+        hash *= M_FNV_PRIME;
+    }
+    return hash;
+}
+
+static char *M_GetCachePath(const uint64_t hash)
+{
+    const char *const fmt = "%s/sample_%016llx.bin";
+    const size_t out_size =
+        snprintf(nullptr, 0, fmt, M_CACHE_DIR, (unsigned long long)hash) + 1;
+    char *const out = Memory_Alloc(out_size);
+    snprintf(out, out_size, fmt, M_CACHE_DIR, (unsigned long long)hash);
+    return out;
+}
+
+static bool M_LoadCached(AUDIO_SAMPLE *const sample, const uint64_t hash)
+{
+    char *path = M_GetCachePath(hash);
+    MYFILE *const fp = File_Open(path, FILE_OPEN_READ);
+    Memory_FreePointer(&path);
+    if (fp == nullptr) {
+        return false;
+    }
+
+    bool result = false;
+    const size_t file_size = File_Size(fp);
+    if (file_size < M_CACHE_HEADER_SIZE) {
+        goto cleanup;
+    }
+
+    const uint32_t magic = File_ReadU32(fp);
+    const uint32_t version = File_ReadU32(fp);
+    const uint32_t rate = File_ReadU32(fp);
+    const uint32_t original_size = File_ReadU32(fp);
+    const uint32_t hash_lo = File_ReadU32(fp);
+    const int32_t num_samples = File_ReadS32(fp);
+    if (magic != M_CACHE_MAGIC || version != M_CACHE_VERSION
+        || rate != AUDIO_WORKING_RATE || original_size != sample->original_size
+        || hash_lo != (uint32_t)hash || num_samples < 0
+        || file_size
+            != M_CACHE_HEADER_SIZE + (size_t)num_samples * sizeof(float)) {
+        goto cleanup;
+    }
+
+    sample->sample_data = Memory_Alloc(MAX(num_samples, 1) * sizeof(float));
+    File_ReadItems(fp, sample->sample_data, num_samples, sizeof(float));
+    sample->num_samples = num_samples;
+    result = true;
+
+cleanup:
+    File_Close(fp);
+    return result;
+}
+
+static void M_SaveCached(const AUDIO_SAMPLE *const sample, const uint64_t hash)
+{
+    File_CreateDirectory(M_CACHE_DIR);
+    char *path = M_GetCachePath(hash);
+    MYFILE *const fp = File_Open(path, FILE_OPEN_WRITE);
+    if (fp == nullptr) {
+        LOG_ERROR("Failed to write sample cache: %s", path);
+        Memory_FreePointer(&path);
+        return;
+    }
+    Memory_FreePointer(&path);
+
+    File_WriteU32(fp, M_CACHE_MAGIC);
+    File_WriteU32(fp, M_CACHE_VERSION);
+    File_WriteU32(fp, AUDIO_WORKING_RATE);
+    File_WriteU32(fp, sample->original_size);
+    File_WriteU32(fp, (uint32_t)hash);
+    File_WriteS32(fp, sample->num_samples);
+    File_WriteItems(
+        fp, sample->sample_data, sample->num_samples, sizeof(float));
+    File_Close(fp);
+}
+
 static bool M_Convert(const int32_t sample_id)
 {
     ASSERT(sample_id >= 0 && sample_id < m_LoadedSamplesCount);
@@ -147,6 +263,17 @@ static bool M_Convert(const int32_t sample_id)
     }
 
     const clock_t time_start = clock();
+    const uint64_t hash =
+        M_HashData(sample->original_data, sample->original_size);
+    if (M_LoadCached(sample, hash)) {
+        const clock_t time_end = clock();
+        const double time_delta =
+            (((double)(time_end - time_start)) / CLOCKS_PER_SEC) * 1000.0f;
+        LOG_DEBUG(
+            "Sample %d loaded from cache (%.0f ms)", sample_id, time_delta);
+        return true;
+    }
+
     size_t working_buffer_size = 0;
     float *working_buffer = nullptr;
 
@@ -354,16 +481,14 @@ static bool M_Convert(const int32_t sample_id)
     int32_t sample_format_bytes = av_get_bytes_per_sample(swr.dst.format);
     sample->num_samples = working_buffer_size / sample_format_bytes
         / swr.dst.ch_layout.nb_channels;
-    sample->channels = swr.src.ch_layout.nb_channels;
     sample->sample_data = working_buffer;
     result = true;
+    M_SaveCached(sample, hash);
 
     const clock_t time_end = clock();
     const double time_delta =
         (((double)(time_end - time_start)) / CLOCKS_PER_SEC) * 1000.0f;
-    LOG_DEBUG(
-        "Sample %d decoded (%.0f ms)", sample_id, sample->original_size,
-        time_delta);
+    LOG_DEBUG("Sample %d decoded (%.0f ms)", sample_id, time_delta);
 
 cleanup:
     if (error_code != 0) {
@@ -391,7 +516,6 @@ cleanup:
         sample->original_data = nullptr;
         sample->original_size = 0;
         sample->num_samples = 0;
-        sample->channels = 0;
         Memory_FreePointer(&working_buffer);
     }
 
@@ -411,8 +535,115 @@ cleanup:
     return result;
 }
 
+static void M_ConvertTask(void *const arg, const int32_t task_idx)
+{
+    const int32_t *const sample_ids = arg;
+    M_Convert(sample_ids[task_idx]);
+}
+
+static int32_t M_FindDuplicate(const int32_t sample_id)
+{
+    const AUDIO_SAMPLE *const sample = &m_LoadedSamples[sample_id];
+    for (int32_t i = 0; i < sample_id; i++) {
+        const AUDIO_SAMPLE *const other = &m_LoadedSamples[i];
+        if (other->original_size == sample->original_size
+            && memcmp(
+                   other->original_data, sample->original_data,
+                   sample->original_size)
+                == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static bool M_Resample(
+    AUDIO_SAMPLE_SOUND *const sound, float *const dst, const int32_t frames)
+{
+    const float *const src = sound->sample->sample_data;
+    const int32_t num_samples = sound->sample->num_samples;
+    const int64_t end = (int64_t)num_samples << M_PHASE_BITS;
+    const int64_t step = (int64_t)(sound->pitch * M_PHASE_ONE);
+    int64_t position = sound->position;
+
+    for (int32_t i = 0; i < frames; i++) {
+        // linear interpolation, continuing into the start of looped sounds
+        const int32_t idx = position >> M_PHASE_BITS;
+        const float frac =
+            (position & (M_PHASE_ONE - 1)) * (1.0f / M_PHASE_ONE);
+        const float a = src[idx];
+        const float b = idx + 1 < num_samples ? src[idx + 1]
+            : sound->is_looped                ? src[0]
+                                              : a;
+        const float value = a + (b - a) * frac;
+        dst[i * AUDIO_WORKING_CHANNELS] = value;
+        dst[i * AUDIO_WORKING_CHANNELS + 1] = value;
+
+        position += step;
+        if (position >= end) {
+            if (!sound->is_looped) {
+                memset(
+                    &dst[(i + 1) * AUDIO_WORKING_CHANNELS], 0,
+                    (frames - i - 1) * AUDIO_WORKING_CHANNELS
+                        * sizeof(float));
+                sound->position = end;
+                return true;
+            }
+            position %= end;
+        }
+    }
+
+    sound->position = position;
+    return false;
+}
+
+static bool M_MixSound(
+    AUDIO_SAMPLE_SOUND *const sound, float *const dst_buffer,
+    const int32_t frames)
+{
+    if (sound->sample->sample_data == nullptr
+        || sound->sample->num_samples <= 0) {
+        return true;
+    }
+
+    // The sound is resampled into a stereo chunk first, so that applying
+    // the channel volumes and accumulating into the mix buffer can be done
+    // a whole vector at a time.
+    float chunk[M_MIX_CHUNK_FRAMES * AUDIO_WORKING_CHANNELS];
+    M_MIX_VEC volume;
+    for (int32_t i = 0; i < M_MIX_VEC_SIZE; i += AUDIO_WORKING_CHANNELS) {
+        volume[i] = sound->volume_l;
+        volume[i + 1] = sound->volume_r;
+    }
+
+    bool is_finished = false;
+    for (int32_t offset = 0; offset < frames && !is_finished;
+         offset += M_MIX_CHUNK_FRAMES) {
+        const int32_t chunk_frames = MIN(M_MIX_CHUNK_FRAMES, frames - offset);
+        const int32_t count = chunk_frames * AUDIO_WORKING_CHANNELS;
+        float *const dst = &dst_buffer[offset * AUDIO_WORKING_CHANNELS];
+        is_finished = M_Resample(sound, chunk, chunk_frames);
+
+        int32_t i = 0;
+        for (; i + M_MIX_VEC_SIZE <= count; i += M_MIX_VEC_SIZE) {
+            M_MIX_VEC src_vec;
+            M_MIX_VEC dst_vec;
+            memcpy(&src_vec, &chunk[i], sizeof(M_MIX_VEC));
+            memcpy(&dst_vec, &dst[i], sizeof(M_MIX_VEC));
+            dst_vec += src_vec * volume;
+            memcpy(&dst[i], &dst_vec, sizeof(M_MIX_VEC));
+        }
+        for (; i < count; i++) {
+            dst[i] += chunk[i] * volume[i % AUDIO_WORKING_CHANNELS];
+        }
+    }
+
+    return is_finished;
+}
+
 void Audio_Sample_Init(void)
 {
+    m_ActiveSoundCount = 0;
     for (int32_t sound_id = 0; sound_id < AUDIO_MAX_ACTIVE_SAMPLES;
          sound_id++) {
         AUDIO_SAMPLE_SOUND *sound = &m_Samples[sound_id];
@@ -421,7 +652,7 @@ void Audio_Sample_Init(void)
         sound->volume = 0.0f;
         sound->pitch = 1.0f;
         sound->pan = 0.0f;
-        sound->current_sample = 0.0f;
+        sound->position = 0;
         sound->sample = nullptr;
     }
 }
@@ -434,6 +665,11 @@ void Audio_Sample_Shutdown(void)
 
     Audio_Sample_CloseAll();
     Audio_Sample_UnloadAll();
+
+    if (m_ThreadPool != nullptr) {
+        ThreadPool_Free(m_ThreadPool);
+        m_ThreadPool = nullptr;
+    }
 }
 
 bool Audio_Sample_Unload(const int32_t sample_id)
@@ -526,6 +762,40 @@ bool Audio_Sample_LoadMany(size_t count, const char **contents, size_t *sizes)
     }
     if (!result) {
         Audio_Sample_UnloadAll();
+        return result;
+    }
+
+    // Decode all samples up front across the available cores rather than
+    // one by one on first play. Identical samples share a cache file, so
+    // only the first of them is decoded and the rest copy its result.
+    int32_t unique_count = 0;
+    int32_t unique_ids[AUDIO_MAX_SAMPLES];
+    int32_t duplicate_of[AUDIO_MAX_SAMPLES];
+    for (int32_t i = 0; i < (int32_t)count; i++) {
+        duplicate_of[i] = M_FindDuplicate(i);
+        if (duplicate_of[i] == -1) {
+            unique_ids[unique_count++] = i;
+        }
+    }
+
+    if (m_ThreadPool == nullptr) {
+        m_ThreadPool = ThreadPool_Create("audio_sample", -1);
+    }
+    ThreadPool_Run(m_ThreadPool, unique_count, M_ConvertTask, unique_ids);
+
+    for (int32_t i = 0; i < (int32_t)count; i++) {
+        if (duplicate_of[i] == -1) {
+            continue;
+        }
+        const AUDIO_SAMPLE *const source = &m_LoadedSamples[duplicate_of[i]];
+        AUDIO_SAMPLE *const sample = &m_LoadedSamples[i];
+        if (source->sample_data == nullptr) {
+            continue;
+        }
+        const size_t size = MAX(source->num_samples, 1) * sizeof(float);
+        sample->sample_data = Memory_Alloc(size);
+        memcpy(sample->sample_data, source->sample_data, size);
+        sample->num_samples = source->num_samples;
     }
     return result;
 }
@@ -561,10 +831,11 @@ int32_t Audio_Sample_Play(
         sound->pitch = pitch;
         sound->pan = pan;
         sound->is_looped = is_looped;
-        sound->current_sample = 0.0f;
+        sound->position = 0;
         sound->sample = &m_LoadedSamples[sample_id];
 
         M_RecalculateChannelVolumes(sound_id);
+        m_ActiveSounds[m_ActiveSoundCount++] = sound_id;
 
         result = sound_id;
         break;
@@ -658,6 +929,14 @@ bool Audio_Sample_Close(int32_t sound_id)
     }
 
     SDL_LockAudioDevice(g_AudioDeviceID);
+    if (m_Samples[sound_id].is_used) {
+        for (int32_t i = 0; i < m_ActiveSoundCount; i++) {
+            if (m_ActiveSounds[i] == sound_id) {
+                m_ActiveSounds[i] = m_ActiveSounds[--m_ActiveSoundCount];
+                break;
+            }
+        }
+    }
     m_Samples[sound_id].is_used = false;
     m_Samples[sound_id].is_playing = false;
     SDL_UnlockAudioDevice(g_AudioDeviceID);
@@ -728,47 +1007,21 @@ bool Audio_Sample_SetPitch(int32_t sound_id, float pitch)
 
 void Audio_Sample_Mix(float *dst_buffer, size_t len)
 {
-    for (int32_t sound_id = 0; sound_id < AUDIO_MAX_ACTIVE_SAMPLES;
-         sound_id++) {
-        AUDIO_SAMPLE_SOUND *sound = &m_Samples[sound_id];
+    Benchmark_BeginZone(BENCHMARK_ZONE_AUDIO_MIX);
+    const int32_t frames = len / sizeof(float) / AUDIO_WORKING_CHANNELS;
+
+    // Iterate backwards, as closing a sound moves the last entry into its
+    // place.
+    for (int32_t i = m_ActiveSoundCount - 1; i >= 0; i--) {
+        const int32_t sound_id = m_ActiveSounds[i];
+        AUDIO_SAMPLE_SOUND *const sound = &m_Samples[sound_id];
         if (!sound->is_playing) {
             continue;
         }
 
-        int32_t samples_requested =
-            len / sizeof(AUDIO_WORKING_FORMAT) / AUDIO_WORKING_CHANNELS;
-        float src_sample_idx = sound->current_sample;
-        const float *src_buffer = sound->sample->sample_data;
-        float *dst_ptr = dst_buffer;
-
-        while ((dst_ptr - dst_buffer) / AUDIO_WORKING_CHANNELS
-               < samples_requested) {
-
-            // because we handle 3d sound ourselves, downmix to mono
-            float src_sample = 0.0f;
-            for (int32_t i = 0; i < sound->sample->channels; i++) {
-                src_sample += src_buffer
-                    [(int32_t)src_sample_idx * sound->sample->channels + i];
-            }
-            src_sample /= (float)sound->sample->channels;
-
-            *dst_ptr++ += src_sample * sound->volume_l;
-            *dst_ptr++ += src_sample * sound->volume_r;
-            src_sample_idx += sound->pitch;
-
-            if ((int32_t)src_sample_idx >= sound->sample->num_samples) {
-                if (sound->is_looped) {
-                    src_sample_idx = 0.0f;
-                } else {
-                    break;
-                }
-            }
-        }
-
-        sound->current_sample = src_sample_idx;
-        if (sound->current_sample >= sound->sample->num_samples
-            && !sound->is_looped) {
+        if (M_MixSound(sound, dst_buffer, frames)) {
             Audio_Sample_Close(sound_id);
         }
     }
+    Benchmark_EndZone(BENCHMARK_ZONE_AUDIO_MIX);
 }
@@ -14,6 +14,7 @@ static Uint64 m_LastCounter = 0;
 static Uint64 m_InitCounter = 0;
 static Uint64 m_Frequency = 0;
 static double m_Accumulator = 0.0;
+static bool m_IsUncapped = false;
 static struct {
     double real_time_at_last_change;
     double sim_time_at_last_change;
@@ -61,7 +62,7 @@ int32_t Clock_WaitTick(void)
     const Uint64 current_counter = SDL_GetPerformanceCounter();
 
     // If this is the first call, just initialize and return a frame.
-    if (m_LastCounter == 0) {
+    if (m_LastCounter == 0 || m_IsUncapped) {
         m_LastCounter = current_counter;
         return 1;
     }
@@ -116,6 +117,17 @@ int32_t Clock_WaitTick(void)
     return frames;
 }
 
+void Clock_SetUncapped(const bool enable)
+{
+    m_IsUncapped = enable;
+    m_Accumulator = 0.0;
+}
+
+bool Clock_IsUncapped(void)
+{
+    return m_IsUncapped;
+}
+
 double Clock_GetRealTime(void)
 {
     return M_GetHighPrecisionCounter();
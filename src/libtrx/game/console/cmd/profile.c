@@ -0,0 +1,45 @@
+#include "benchmark.h"
+#include "game/console/common.h"
+#include "game/console/registry.h"
+#include "game/game_string.h"
+#include "strings.h"
+
+static void M_ShowStatus(void);
+static COMMAND_RESULT M_Entrypoint(const COMMAND_CONTEXT *ctx);
+
+static void M_ShowStatus(void)
+{
+    BENCHMARK_ZONE_STATS stats;
+    if (!Benchmark_GetZoneStats(BENCHMARK_ZONE_FRAME, &stats)) {
+        Console_Log(GS(OSD_PROFILE_NO_DATA));
+        return;
+    }
+    Console_Log(GS(OSD_PROFILE_STATS), stats.avg, stats.p99, stats.frames);
+}
+
+static COMMAND_RESULT M_Entrypoint(const COMMAND_CONTEXT *const ctx)
+{
+    if (String_Match(ctx->args, "^(on|true|1)$")) {
+        Benchmark_SetProfiling(true);
+        Console_Log(GS(OSD_PROFILE_ON));
+        return CR_SUCCESS;
+    } else if (String_Match(ctx->args, "^(off|false|0)$")) {
+        Benchmark_SetProfiling(false);
+        Console_Log(GS(OSD_PROFILE_OFF));
+        return CR_SUCCESS;
+    } else if (String_IsEmpty(ctx->args)) {
+        M_ShowStatus();
+        return CR_SUCCESS;
+    } else if (String_Match(ctx->args, "^.+\\.(json|csv)$")) {
+        if (Benchmark_DumpZones(ctx->args)) {
+            Console_Log(GS(OSD_PROFILE_DUMP), ctx->args);
+        } else {
+            Console_Log(GS(OSD_PROFILE_DUMP_FAIL), ctx->args);
+        }
+        return CR_SUCCESS;
+    } else {
+        return CR_BAD_INVOCATION;
+    }
+}
+
+REGISTER_CONSOLE_COMMAND("profile", M_Entrypoint)
@@ -26,7 +26,10 @@ static COMMAND_RESULT M_Entrypoint(const COMMAND_CONTEXT *const ctx)
         return CR_BAD_INVOCATION;
     }
 
-    Savegame_Save(slot_idx);
+    if (!Savegame_Save(slot_idx)) {
+        Console_Log(GS(OSD_SAVE_GAME_FAIL), slot_num);
+        return CR_FAILURE;
+    }
     Console_Log(GS(OSD_SAVE_GAME), slot_num);
     return CR_SUCCESS;
 }
@@ -0,0 +1,215 @@
+#include "benchmark.h"
+#include "debug.h"
+#include "engine/audio.h"
+#include "game/clock.h"
+#include "game/demo.h"
+#include "game/game_flow.h"
+#include "game/items.h"
+#include "game/shell.h"
+#include "gfx/context.h"
+#include "log.h"
+#include "strings.h"
+#include "utils.h"
+
+#include <SDL2/SDL_hints.h>
+#include <SDL2/SDL_timer.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_BENCHMARK_DEMOS 32
+#define FNV_OFFSET 0x811C9DC5
+#define FNV_PRIME 0x01000193
+
+typedef struct {
+    int32_t demo_num;
+    int32_t frames;
+    double elapsed;
+    uint32_t checksum;
+} M_RESULT;
+
+static bool m_IsActive = false;
+static bool m_IsRunning = false;
+static Uint64 m_StartCounter = 0;
+static int32_t m_DemoCount = 0;
+static int32_t m_Demos[MAX_BENCHMARK_DEMOS] = {};
+static int32_t m_ResultCount = 0;
+static M_RESULT m_Results[MAX_BENCHMARK_DEMOS] = {};
+
+static bool M_ParseDemoList(const char *list);
+static uint32_t M_Hash(uint32_t hash, int32_t value);
+static uint32_t M_ComputeChecksum(void);
+static void M_LogZones(void);
+static void M_LogSummary(void);
+
+static bool M_ParseDemoList(const char *const list)
+{
+    const char *ptr = list;
+    while (*ptr != '\0') {
+        char *end;
+        const long demo_num = strtol(ptr, &end, 10);
+        if (end == ptr || demo_num < 0 || m_DemoCount >= MAX_BENCHMARK_DEMOS) {
+            return false;
+        }
+        m_Demos[m_DemoCount++] = demo_num;
+        ptr = *end == ',' ? end + 1 : end;
+    }
+    return true;
+}
+
+static uint32_t M_Hash(uint32_t hash, const int32_t value)
+{
+    for (int32_t i = 0; i < 4; i++) {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint32_t M_ComputeChecksum(void)
+{
+    uint32_t hash = FNV_OFFSET;
+    for (int32_t i = 0; i < Item_GetTotalCount(); i++) {
+        const ITEM *const item = Item_Get(i);
+        hash = M_Hash(hash, item->object_id);
+        hash = M_Hash(hash, item->room_num);
+        hash = M_Hash(hash, item->pos.x);
+        hash = M_Hash(hash, item->pos.y);
+        hash = M_Hash(hash, item->pos.z);
+        hash = M_Hash(hash, item->rot.x);
+        hash = M_Hash(hash, item->rot.y);
+        hash = M_Hash(hash, item->rot.z);
+        hash = M_Hash(hash, item->anim_num);
+        hash = M_Hash(hash, item->frame_num);
+        hash = M_Hash(hash, item->current_anim_state);
+        hash = M_Hash(hash, item->goal_anim_state);
+        hash = M_Hash(hash, item->speed);
+        hash = M_Hash(hash, item->fall_speed);
+        hash = M_Hash(hash, item->hit_points);
+        hash = M_Hash(hash, item->flags);
+        hash = M_Hash(hash, item->status);
+    }
+    return hash;
+}
+
+static void M_LogZones(void)
+{
+    for (int32_t i = 0; i < BENCHMARK_ZONE_NUMBER_OF; i++) {
+        BENCHMARK_ZONE_STATS stats;
+        if (!Benchmark_GetZoneStats(i, &stats)) {
+            continue;
+        }
+        LOG_INFO(
+            "  %-16s avg %7.3f ms  p99 %7.3f ms  max %7.3f ms",
+            Benchmark_GetZoneName(i), stats.avg, stats.p99, stats.max);
+    }
+}
+
+static void M_LogSummary(void)
+{
+    int32_t total_frames = 0;
+    double total_elapsed = 0.0;
+    uint32_t checksum = FNV_OFFSET;
+    for (int32_t i = 0; i < m_ResultCount; i++) {
+        const M_RESULT *const result = &m_Results[i];
+        total_frames += result->frames;
+        total_elapsed += result->elapsed;
+        checksum = M_Hash(checksum, result->checksum);
+    }
+
+    LOG_INFO(
+        "Benchmark finished: %d demos, %d frames in %.2f s (%.2f FPS), "
+        "checksum %08X",
+        m_ResultCount, total_frames, total_elapsed,
+        total_elapsed > 0.0 ? total_frames / total_elapsed : 0.0, checksum);
+}
+
+bool Demo_Benchmark_ParseArgs(const int32_t arg_count, char **const args)
+{
+    for (int32_t i = 1; i < arg_count; i++) {
+        if (String_Equivalent(args[i], "-benchmark")) {
+            m_IsActive = true;
+        } else if (strncmp(args[i], "-benchmark=", 11) == 0) {
+            m_IsActive = true;
+            if (!M_ParseDemoList(args[i] + 11)) {
+                LOG_ERROR("Invalid demo list: %s", args[i] + 11);
+                m_DemoCount = 0;
+            }
+        }
+    }
+
+    if (m_IsActive) {
+        // Environment variables still take precedence over these hints, so a
+        // different video driver can be forced if offscreen is unavailable.
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+        Audio_Disable();
+    }
+    return m_IsActive;
+}
+
+bool Demo_Benchmark_IsActive(void)
+{
+    return m_IsActive;
+}
+
+GF_COMMAND Demo_Benchmark_Run(void)
+{
+    ASSERT(m_IsActive);
+
+    const int32_t demo_count = GF_GetLevelTable(GFLT_DEMOS)->count;
+    if (m_DemoCount == 0) {
+        for (int32_t i = 0; i < MIN(demo_count, MAX_BENCHMARK_DEMOS); i++) {
+            m_Demos[m_DemoCount++] = i;
+        }
+    }
+
+    Clock_SetUncapped(true);
+    GFX_Context_SetVSync(false);
+    Benchmark_SetProfiling(true);
+
+    for (int32_t i = 0; i < m_DemoCount && !Shell_IsExiting(); i++) {
+        if (m_Demos[i] >= demo_count) {
+            LOG_ERROR("Invalid demo: %d", m_Demos[i]);
+            continue;
+        }
+        GF_DoDemoSequence(m_Demos[i]);
+    }
+
+    Benchmark_SetProfiling(false);
+    Clock_SetUncapped(false);
+    M_LogSummary();
+
+    return (GF_COMMAND) { .action = GF_EXIT_GAME };
+}
+
+void Demo_Benchmark_Begin(const int32_t demo_num)
+{
+    if (!m_IsActive || m_ResultCount >= MAX_BENCHMARK_DEMOS) {
+        return;
+    }
+
+    m_IsRunning = true;
+    m_Results[m_ResultCount].demo_num = demo_num;
+    Benchmark_ResetZones();
+    m_StartCounter = SDL_GetPerformanceCounter();
+}
+
+void Demo_Benchmark_End(void)
+{
+    if (!m_IsRunning) {
+        return;
+    }
+
+    m_IsRunning = false;
+    M_RESULT *const result = &m_Results[m_ResultCount++];
+    result->frames = Benchmark_GetFrameCount();
+    result->elapsed = (SDL_GetPerformanceCounter() - m_StartCounter)
+        / (double)SDL_GetPerformanceFrequency();
+    result->checksum = M_ComputeChecksum();
+
+    LOG_INFO(
+        "Demo %d: %d frames in %.2f s (%.2f FPS), checksum %08X",
+        result->demo_num, result->frames, result->elapsed,
+        result->elapsed > 0.0 ? result->frames / result->elapsed : 0.0,
+        result->checksum);
+    M_LogZones();
+}
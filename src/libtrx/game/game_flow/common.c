@@ -1,6 +1,7 @@
 #include "game/game_flow/common.h"
 
 #include "debug.h"
+#include "game/game_flow/prefetch.h"
 #include "game/game_flow/vars.h"
 #include "memory.h"
 
@@ -74,6 +75,8 @@ static void M_FreeFMVs(GAME_FLOW *const gf)
 
 void GF_Shutdown(void)
 {
+    GF_CancelPrefetch();
+
     GAME_FLOW *const gf = &g_GameFlow;
     M_FreeInjections(&gf->injections);
 
@@ -0,0 +1,99 @@
+#include "game/game_flow/prefetch.h"
+
+#include "filesystem.h"
+#include "log.h"
+#include "memory.h"
+
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_thread.h>
+
+#define M_CHUNK_SIZE (256 * 1024)
+
+typedef struct {
+    int32_t path_count;
+    char **paths;
+    SDL_atomic_t is_cancelled;
+} M_PREFETCH;
+
+static const GF_LEVEL *m_Level = nullptr;
+static SDL_Thread *m_Thread = nullptr;
+static M_PREFETCH m_Prefetch = {};
+
+static void M_ReadFile(const char *path, char *buffer);
+static int M_PrefetchThread(void *arg);
+static void M_Wait(void);
+
+static void M_ReadFile(const char *const path, char *const buffer)
+{
+    MYFILE *const fp = File_Open(path, FILE_OPEN_READ);
+    if (fp == nullptr) {
+        return;
+    }
+
+    size_t remaining = File_Size(fp);
+    while (remaining > 0 && SDL_AtomicGet(&m_Prefetch.is_cancelled) == 0) {
+        const size_t size = remaining < M_CHUNK_SIZE ? remaining : M_CHUNK_SIZE;
+        File_ReadData(fp, buffer, size);
+        remaining -= size;
+    }
+    File_Close(fp);
+}
+
+static int M_PrefetchThread(void *const arg)
+{
+    M_PREFETCH *const prefetch = arg;
+    char *buffer = Memory_Alloc(M_CHUNK_SIZE);
+    for (int32_t i = 0; i < prefetch->path_count; i++) {
+        M_ReadFile(prefetch->paths[i], buffer);
+    }
+    Memory_FreePointer(&buffer);
+    return 0;
+}
+
+static void M_Wait(void)
+{
+    if (m_Thread != nullptr) {
+        SDL_WaitThread(m_Thread, nullptr);
+        m_Thread = nullptr;
+    }
+
+    for (int32_t i = 0; i < m_Prefetch.path_count; i++) {
+        Memory_FreePointer(&m_Prefetch.paths[i]);
+    }
+    Memory_FreePointer(&m_Prefetch.paths);
+    m_Prefetch.path_count = 0;
+}
+
+void GF_PrefetchLevel(const GF_LEVEL *const level)
+{
+    if (level == nullptr || level->path == nullptr || level == m_Level) {
+        return;
+    }
+
+    // A prefetch for another level is of no more use, so stop it early.
+    GF_CancelPrefetch();
+    m_Level = level;
+
+    const INJECTION_DATA *const injections = &level->injections;
+    m_Prefetch.paths = Memory_Alloc(sizeof(char *) * (injections->count + 1));
+    m_Prefetch.paths[m_Prefetch.path_count++] = Memory_DupStr(level->path);
+    for (int32_t i = 0; i < injections->count; i++) {
+        m_Prefetch.paths[m_Prefetch.path_count++] =
+            Memory_DupStr(injections->data_paths[i]);
+    }
+    SDL_AtomicSet(&m_Prefetch.is_cancelled, 0);
+
+    LOG_DEBUG("prefetching level %d (%s)", level->num, level->path);
+    m_Thread = SDL_CreateThread(M_PrefetchThread, "level_prefetch", &m_Prefetch);
+    if (m_Thread == nullptr) {
+        LOG_ERROR("SDL_CreateThread(): %s", SDL_GetError());
+        M_Wait();
+    }
+}
+
+void GF_CancelPrefetch(void)
+{
+    SDL_AtomicSet(&m_Prefetch.is_cancelled, 1);
+    M_Wait();
+    m_Level = nullptr;
+}
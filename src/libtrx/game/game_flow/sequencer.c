@@ -2,6 +2,8 @@
 
 #include "debug.h"
 #include "enum_map.h"
+#include "game/game_flow/common.h"
+#include "game/game_flow/prefetch.h"
 #include "game/game_flow/sequencer_priv.h"
 
 #define M_MAX_QUEUE_SIZE 10
@@ -11,6 +13,8 @@ static GF_COMMAND M_RunEvent(
     GF_SEQUENCE_CONTEXT seq_ctx, void *seq_ctx_arg);
 static bool M_PostponeEvent(const GF_SEQUENCE_EVENT *event);
 static void M_ResetQueue(GF_EVENT_QUEUE_TYPE queue_type);
+static bool M_IsWaitingEvent(GF_SEQUENCE_EVENT_TYPE event_type);
+static void M_PrefetchNextLevel(const GF_LEVEL *level, int32_t event_idx);
 
 typedef struct {
     int32_t count;
@@ -65,6 +69,36 @@ static void M_ResetQueue(const GF_EVENT_QUEUE_TYPE queue_type)
     queue->count = 0;
 }
 
+static bool M_IsWaitingEvent(const GF_SEQUENCE_EVENT_TYPE event_type)
+{
+    switch (event_type) {
+    case GFS_DISPLAY_PICTURE:
+    case GFS_PLAY_FMV:
+    case GFS_LEVEL_STATS:
+    case GFS_TOTAL_STATS:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void M_PrefetchNextLevel(
+    const GF_LEVEL *const level, const int32_t event_idx)
+{
+    // Events before the level starts lead into this level, and events after
+    // it lead into the next one. A wrong guess only costs some disk reads.
+    const GF_SEQUENCE *const sequence = &level->sequence;
+    for (int32_t i = event_idx + 1; i < sequence->length; i++) {
+        if (sequence->events[i].type == GFS_LOOP_GAME) {
+            GF_PrefetchLevel(level);
+            return;
+        }
+    }
+    if (GF_GetLevelTableType(level->type) == GFLT_MAIN) {
+        GF_PrefetchLevel(GF_GetLevelAfter(level));
+    }
+}
+
 GF_COMMAND GF_InterpretSequence(
     const GF_LEVEL *const level, GF_SEQUENCE_CONTEXT seq_ctx,
     void *const seq_ctx_arg)
@@ -89,6 +123,11 @@ GF_COMMAND GF_InterpretSequence(
             continue;
         }
 
+        // Warm the file cache for the next level while the player watches
+        if (M_IsWaitingEvent(event->type)) {
+            M_PrefetchNextLevel(level, i);
+        }
+
         // Handle the event
         gf_cmd = M_RunEvent(level, event, seq_ctx, seq_ctx_arg);
         if (gf_cmd.action != GF_NOOP) {
@@ -29,8 +29,10 @@ static RGBA_8888 M_ARGB1555To8888(uint16_t argb1555);
 static void M_ReadPosition(XYZ_32 *pos, VFILE *file);
 static void M_ReadShade(SHADE *shade, VFILE *file);
 static void M_ReadVertex(XYZ_16 *vertex, VFILE *file);
-static void M_ReadFace4(FACE4 *face, VFILE *file);
-static void M_ReadFace3(FACE3 *face, VFILE *file);
+static void M_ReadVertices(XYZ_16 *vertices, int32_t count, VFILE *file);
+static uint16_t M_GetU16(const char *data);
+static void M_ReadFace4s(FACE4 *faces, int32_t count, VFILE *file);
+static void M_ReadFace3s(FACE3 *faces, int32_t count, VFILE *file);
 static void M_ReadRoomMesh(int32_t room_num, VFILE *file);
 static void M_ReadObjectMesh(OBJECT_MESH *mesh, VFILE *file);
 static void M_ReadBounds16(BOUNDS_16 *bounds, VFILE *file);
@@ -82,22 +84,46 @@ static void M_ReadVertex(XYZ_16 *const vertex, VFILE *const file)
     vertex->z = VFile_ReadS16(file);
 }
 
-static void M_ReadFace4(FACE4 *const face, VFILE *const file)
+static void M_ReadVertices(
+    XYZ_16 *const vertices, const int32_t count, VFILE *const file)
 {
-    for (int32_t i = 0; i < 4; i++) {
-        face->vertices[i] = VFile_ReadU16(file);
+    // XYZ_16 has no padding, so the vertices can be copied as they are.
+    VFile_Read(file, vertices, sizeof(XYZ_16) * count);
+}
+
+static uint16_t M_GetU16(const char *const data)
+{
+    uint16_t result;
+    memcpy(&result, data, sizeof(result));
+    return result;
+}
+
+static void M_ReadFace4s(
+    FACE4 *const faces, const int32_t count, VFILE *const file)
+{
+    const size_t face_size = sizeof(uint16_t) * 5;
+    const char *data = VFile_ReadView(file, face_size * count);
+    for (int32_t i = 0; i < count; i++) {
+        FACE4 *const face = &faces[i];
+        memcpy(face->vertices, data, sizeof(uint16_t) * 4);
+        face->texture_idx = M_GetU16(data + sizeof(uint16_t) * 4);
+        face->enable_reflections = false;
+        data += face_size;
     }
-    face->texture_idx = VFile_ReadU16(file);
-    face->enable_reflections = false;
 }
 
-static void M_ReadFace3(FACE3 *const face, VFILE *const file)
+static void M_ReadFace3s(
+    FACE3 *const faces, const int32_t count, VFILE *const file)
 {
-    for (int32_t i = 0; i < 3; i++) {
-        face->vertices[i] = VFile_ReadU16(file);
+    const size_t face_size = sizeof(uint16_t) * 4;
+    const char *data = VFile_ReadView(file, face_size * count);
+    for (int32_t i = 0; i < count; i++) {
+        FACE3 *const face = &faces[i];
+        memcpy(face->vertices, data, sizeof(uint16_t) * 3);
+        face->texture_idx = M_GetU16(data + sizeof(uint16_t) * 3);
+        face->enable_reflections = false;
+        data += face_size;
     }
-    face->texture_idx = VFile_ReadU16(file);
-    face->enable_reflections = false;
 }
 
 static void M_ReadRoomMesh(const int32_t room_num, VFILE *const file)
@@ -114,18 +140,26 @@ static void M_ReadRoomMesh(const int32_t room_num, VFILE *const file)
             room->mesh.num_vertices + inj_data.num_vertices;
         room->mesh.vertices =
             GameBuf_Alloc(sizeof(ROOM_VERTEX) * alloc_count, GBUF_ROOM_MESH);
+#if TR_VERSION == 1
+        const size_t vertex_size = sizeof(int16_t) * 4;
+#elif TR_VERSION == 2
+        const size_t vertex_size = sizeof(int16_t) * 6;
+#endif
+        const char *data =
+            VFile_ReadView(file, vertex_size * room->mesh.num_vertices);
         for (int32_t i = 0; i < room->mesh.num_vertices; i++) {
             ROOM_VERTEX *const vertex = &room->mesh.vertices[i];
-            M_ReadVertex(&vertex->pos, file);
-            vertex->light_base = VFile_ReadS16(file);
+            memcpy(&vertex->pos, data, sizeof(XYZ_16));
+            vertex->light_base = (int16_t)M_GetU16(data + 6);
 #if TR_VERSION == 1
             vertex->flags = 0;
             vertex->light_adder = vertex->light_base;
 #elif TR_VERSION == 2
-            vertex->light_table_value = VFile_ReadU8(file);
-            vertex->flags = VFile_ReadU8(file);
-            vertex->light_adder = VFile_ReadS16(file);
+            vertex->light_table_value = (uint8_t)data[8];
+            vertex->flags = (uint8_t)data[9];
+            vertex->light_adder = (int16_t)M_GetU16(data + 10);
 #endif
+            data += vertex_size;
         }
     }
 
@@ -134,9 +168,7 @@ static void M_ReadRoomMesh(const int32_t room_num, VFILE *const file)
         const int32_t alloc_count = room->mesh.num_face4s + inj_data.num_quads;
         room->mesh.face4s =
             GameBuf_Alloc(sizeof(FACE4) * alloc_count, GBUF_ROOM_MESH);
-        for (int32_t i = 0; i < room->mesh.num_face4s; i++) {
-            M_ReadFace4(&room->mesh.face4s[i], file);
-        }
+        M_ReadFace4s(room->mesh.face4s, room->mesh.num_face4s, file);
     }
 
     {
@@ -145,9 +177,7 @@ static void M_ReadRoomMesh(const int32_t room_num, VFILE *const file)
             room->mesh.num_face3s + inj_data.num_triangles;
         room->mesh.face3s =
             GameBuf_Alloc(sizeof(FACE4) * alloc_count, GBUF_ROOM_MESH);
-        for (int32_t i = 0; i < room->mesh.num_face3s; i++) {
-            M_ReadFace3(&room->mesh.face3s[i], file);
-        }
+        M_ReadFace3s(room->mesh.face3s, room->mesh.num_face3s, file);
     }
 
     {
@@ -156,10 +186,13 @@ static void M_ReadRoomMesh(const int32_t room_num, VFILE *const file)
             room->mesh.num_sprites + inj_data.num_sprites;
         room->mesh.sprites =
             GameBuf_Alloc(sizeof(ROOM_SPRITE) * alloc_count, GBUF_ROOM_MESH);
+        const char *data = VFile_ReadView(
+            file, sizeof(uint16_t) * 2 * room->mesh.num_sprites);
         for (int32_t i = 0; i < room->mesh.num_sprites; i++) {
             ROOM_SPRITE *const sprite = &room->mesh.sprites[i];
-            sprite->vertex = VFile_ReadU16(file);
-            sprite->texture = VFile_ReadU16(file);
+            sprite->vertex = M_GetU16(data);
+            sprite->texture = M_GetU16(data + sizeof(uint16_t));
+            data += sizeof(uint16_t) * 2;
         }
     }
 
@@ -180,9 +213,7 @@ static void M_ReadObjectMesh(OBJECT_MESH *const mesh, VFILE *const file)
         mesh->num_vertices = VFile_ReadS16(file);
         mesh->vertices =
             GameBuf_Alloc(sizeof(XYZ_16) * mesh->num_vertices, GBUF_MESHES);
-        for (int32_t i = 0; i < mesh->num_vertices; i++) {
-            M_ReadVertex(&mesh->vertices[i], file);
-        }
+        M_ReadVertices(mesh->vertices, mesh->num_vertices, file);
     }
 
     {
@@ -190,15 +221,12 @@ static void M_ReadObjectMesh(OBJECT_MESH *const mesh, VFILE *const file)
         if (mesh->num_lights > 0) {
             mesh->lighting.normals =
                 GameBuf_Alloc(sizeof(XYZ_16) * mesh->num_lights, GBUF_MESHES);
-            for (int32_t i = 0; i < mesh->num_lights; i++) {
-                M_ReadVertex(&mesh->lighting.normals[i], file);
-            }
+            M_ReadVertices(mesh->lighting.normals, mesh->num_lights, file);
         } else {
             mesh->lighting.lights = GameBuf_Alloc(
                 sizeof(int16_t) * ABS(mesh->num_lights), GBUF_MESHES);
-            for (int32_t i = 0; i < ABS(mesh->num_lights); i++) {
-                mesh->lighting.lights[i] = VFile_ReadS16(file);
-            }
+            VFile_ReadS16Array(
+                file, mesh->lighting.lights, ABS(mesh->num_lights));
         }
     }
 
@@ -206,36 +234,28 @@ static void M_ReadObjectMesh(OBJECT_MESH *const mesh, VFILE *const file)
         mesh->num_tex_face4s = VFile_ReadS16(file);
         mesh->tex_face4s =
             GameBuf_Alloc(sizeof(FACE4) * mesh->num_tex_face4s, GBUF_MESHES);
-        for (int32_t i = 0; i < mesh->num_tex_face4s; i++) {
-            M_ReadFace4(&mesh->tex_face4s[i], file);
-        }
+        M_ReadFace4s(mesh->tex_face4s, mesh->num_tex_face4s, file);
     }
 
     {
         mesh->num_tex_face3s = VFile_ReadS16(file);
         mesh->tex_face3s =
             GameBuf_Alloc(sizeof(FACE3) * mesh->num_tex_face3s, GBUF_MESHES);
-        for (int32_t i = 0; i < mesh->num_tex_face3s; i++) {
-            M_ReadFace3(&mesh->tex_face3s[i], file);
-        }
+        M_ReadFace3s(mesh->tex_face3s, mesh->num_tex_face3s, file);
     }
 
     {
         mesh->num_flat_face4s = VFile_ReadS16(file);
         mesh->flat_face4s =
             GameBuf_Alloc(sizeof(FACE4) * mesh->num_flat_face4s, GBUF_MESHES);
-        for (int32_t i = 0; i < mesh->num_flat_face4s; i++) {
-            M_ReadFace4(&mesh->flat_face4s[i], file);
-        }
+        M_ReadFace4s(mesh->flat_face4s, mesh->num_flat_face4s, file);
     }
 
     {
         mesh->num_flat_face3s = VFile_ReadS16(file);
         mesh->flat_face3s =
             GameBuf_Alloc(sizeof(FACE3) * mesh->num_flat_face3s, GBUF_MESHES);
-        for (int32_t i = 0; i < mesh->num_flat_face3s; i++) {
-            M_ReadFace3(&mesh->flat_face3s[i], file);
-        }
+        M_ReadFace3s(mesh->flat_face3s, mesh->num_flat_face3s, file);
     }
 }
 
@@ -326,13 +346,11 @@ void Level_ReadTexturePages(
 #else
     const int32_t texture_size_16_bit =
         num_pages * TEXTURE_PAGE_SIZE * sizeof(uint16_t);
-    uint16_t *input = Memory_Alloc(texture_size_16_bit);
-    uint16_t *input_ptr = input;
-    VFile_Read(file, input, texture_size_16_bit);
+    const char *input = VFile_ReadView(file, texture_size_16_bit);
     for (int32_t i = 0; i < num_pages * TEXTURE_PAGE_SIZE; i++) {
-        *output++ = M_ARGB1555To8888(*input_ptr++);
+        *output++ = M_ARGB1555To8888(M_GetU16(input));
+        input += sizeof(uint16_t);
     }
-    Memory_FreePointer(&input);
 #endif
 
     Benchmark_End(benchmark, nullptr);
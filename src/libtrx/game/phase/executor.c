@@ -1,5 +1,6 @@
 #include "game/phase/executor.h"
 
+#include "benchmark.h"
 #include "config.h"
 #include "game/clock.h"
 #include "game/console/common.h"
@@ -60,6 +61,7 @@ static PHASE_CONTROL M_Control(PHASE *const phase, const int32_t nframes)
 
 static void M_Draw(PHASE *const phase)
 {
+    Benchmark_BeginZone(BENCHMARK_ZONE_DRAW);
     Output_BeginScene();
     if (phase != nullptr && phase->draw != nullptr) {
         phase->draw(phase);
@@ -67,10 +69,13 @@ static void M_Draw(PHASE *const phase)
 
     Console_Draw();
     Text_Draw();
+    Benchmark_BeginZone(BENCHMARK_ZONE_DRAW_POLY_LIST);
     Output_DrawPolyList();
+    Benchmark_EndZone(BENCHMARK_ZONE_DRAW_POLY_LIST);
     Fader_Draw(&m_ExitFader);
 
     Output_EndScene();
+    Benchmark_EndZone(BENCHMARK_ZONE_DRAW);
 }
 
 static int32_t M_Wait(PHASE *const phase)
@@ -107,8 +112,11 @@ GF_COMMAND PhaseExecutor_Run(PHASE *const phase)
     }
 
     int32_t nframes = Clock_WaitTick();
+    Benchmark_BeginFrame();
     while (true) {
+        Benchmark_BeginZone(BENCHMARK_ZONE_CONTROL);
         const PHASE_CONTROL control = M_Control(phase, nframes);
+        Benchmark_EndZone(BENCHMARK_ZONE_CONTROL);
 
         if (control.action == PHASE_ACTION_END) {
             if (Shell_IsExiting()) {
@@ -131,6 +139,7 @@ GF_COMMAND PhaseExecutor_Run(PHASE *const phase)
             Interpolation_SetRate(1.0);
             M_Draw(phase);
             nframes += M_Wait(phase);
+            Benchmark_EndFrame();
         }
     }
 
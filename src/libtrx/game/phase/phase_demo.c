@@ -49,12 +49,14 @@ static PHASE_CONTROL M_Start(PHASE *const phase)
 
     p->state = STATE_RUN;
     Game_SetIsPlaying(true);
+    Demo_Benchmark_Begin(p->level_num);
 
     return (PHASE_CONTROL) { .action = PHASE_ACTION_CONTINUE };
 }
 
 static void M_End(PHASE *const phase)
 {
+    Demo_Benchmark_End();
     Demo_End();
 }
 
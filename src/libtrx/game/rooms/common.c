@@ -8,6 +8,7 @@
 #include "game/rooms/const.h"
 #include "game/rooms/enum.h"
 #include "game/sound/common.h"
+#include "memory.h"
 #include "utils.h"
 
 #define FD_NULL_INDEX 0
@@ -26,6 +27,9 @@
     #define FD_LADDER_TYPE(t) ((t & 0x7F00) >> 8)
 #endif
 
+// Largest number of grid cells along either axis of the room lookup grid.
+#define ROOM_GRID_MAX_CELLS 128
+
 static int32_t m_RoomCount = 0;
 static ROOM *m_Rooms = nullptr;
 static bool m_FlipStatus = false;
@@ -33,10 +37,28 @@ static int32_t m_FlipEffect = -1;
 static int32_t m_FlipTimer = 0;
 static int32_t m_FlipSlotFlags[MAX_FLIP_MAPS] = {};
 
+// A uniform grid over the X/Z plane, listing the rooms that overlap each cell
+// in ascending order so that lookups match a linear scan.
+static struct {
+    bool is_valid;
+    int32_t min_x;
+    int32_t min_z;
+    int32_t shift;
+    int32_t size_x;
+    int32_t size_z;
+    int32_t *cell_starts;
+    int16_t *room_nums;
+} m_RoomGrid = {};
+
 static const int16_t *M_ReadTrigger(
     const int16_t *data, int16_t fd_entry, SECTOR *sector);
 static void M_AddFlipItems(const ROOM *room);
 static void M_RemoveFlipItems(const ROOM *room);
+static bool M_GetRoomCells(
+    const ROOM *room, int32_t *x1, int32_t *z1, int32_t *x2, int32_t *z2);
+static void M_FreeRoomGrid(void);
+static void M_BuildRoomGrid(void);
+static bool M_IsInRoom(const ROOM *room, int32_t x, int32_t y, int32_t z);
 
 static const int16_t *M_ReadTrigger(
     const int16_t *data, const int16_t fd_entry, SECTOR *const sector)
@@ -170,8 +192,112 @@ static void M_RemoveFlipItems(const ROOM *const room)
     }
 }
 
+static bool M_GetRoomCells(
+    const ROOM *const room, int32_t *const x1, int32_t *const z1,
+    int32_t *const x2, int32_t *const z2)
+{
+    // Inclusive range of cells covered by the room's inner area, which is
+    // what M_IsInRoom tests against.
+    const int32_t min_x = room->pos.x + WALL_L;
+    const int32_t max_x = room->pos.x + (room->size.x - 1) * WALL_L;
+    const int32_t min_z = room->pos.z + WALL_L;
+    const int32_t max_z = room->pos.z + (room->size.z - 1) * WALL_L;
+    if (max_x <= min_x || max_z <= min_z) {
+        return false;
+    }
+    *x1 = (min_x - m_RoomGrid.min_x) >> m_RoomGrid.shift;
+    *z1 = (min_z - m_RoomGrid.min_z) >> m_RoomGrid.shift;
+    *x2 = (max_x - 1 - m_RoomGrid.min_x) >> m_RoomGrid.shift;
+    *z2 = (max_z - 1 - m_RoomGrid.min_z) >> m_RoomGrid.shift;
+    return true;
+}
+
+static void M_FreeRoomGrid(void)
+{
+    Memory_FreePointer(&m_RoomGrid.cell_starts);
+    Memory_FreePointer(&m_RoomGrid.room_nums);
+    m_RoomGrid.is_valid = false;
+}
+
+static void M_BuildRoomGrid(void)
+{
+    M_FreeRoomGrid();
+    if (m_RoomCount == 0) {
+        return;
+    }
+
+    const BOUNDS_32 bounds = Room_GetWorldBounds();
+    m_RoomGrid.min_x = bounds.min.x;
+    m_RoomGrid.min_z = bounds.min.z;
+    m_RoomGrid.shift = WALL_SHIFT + 2;
+    while (((bounds.max.x - bounds.min.x) >> m_RoomGrid.shift)
+               >= ROOM_GRID_MAX_CELLS
+           || ((bounds.max.z - bounds.min.z) >> m_RoomGrid.shift)
+               >= ROOM_GRID_MAX_CELLS) {
+        m_RoomGrid.shift++;
+    }
+    m_RoomGrid.size_x = ((bounds.max.x - bounds.min.x) >> m_RoomGrid.shift) + 1;
+    m_RoomGrid.size_z = ((bounds.max.z - bounds.min.z) >> m_RoomGrid.shift) + 1;
+
+    // Count the rooms in each cell, turn the counts into offsets, then fill
+    // the cells in room order.
+    const int32_t cell_count = m_RoomGrid.size_x * m_RoomGrid.size_z;
+    int32_t *const cell_starts =
+        Memory_Alloc(sizeof(int32_t) * (cell_count + 1));
+    for (int32_t pass = 0; pass < 2; pass++) {
+        for (int32_t i = 0; i < m_RoomCount; i++) {
+            const ROOM *const room = &m_Rooms[i];
+            int32_t x1, z1, x2, z2;
+            if (room->flip_status == RFS_FLIPPED
+                || !M_GetRoomCells(room, &x1, &z1, &x2, &z2)) {
+                continue;
+            }
+            for (int32_t x = x1; x <= x2; x++) {
+                for (int32_t z = z1; z <= z2; z++) {
+                    const int32_t cell = z + x * m_RoomGrid.size_z;
+                    if (pass == 0) {
+                        cell_starts[cell + 1]++;
+                    } else {
+                        m_RoomGrid.room_nums[cell_starts[cell]++] = i;
+                    }
+                }
+            }
+        }
+
+        if (pass == 0) {
+            for (int32_t cell = 0; cell < cell_count; cell++) {
+                cell_starts[cell + 1] += cell_starts[cell];
+            }
+            m_RoomGrid.room_nums = Memory_Alloc(
+                sizeof(int16_t) * MAX(cell_starts[cell_count], 1));
+        } else {
+            // Filling advanced every start to the next cell's start.
+            for (int32_t cell = cell_count; cell > 0; cell--) {
+                cell_starts[cell] = cell_starts[cell - 1];
+            }
+            cell_starts[0] = 0;
+        }
+    }
+
+    m_RoomGrid.cell_starts = cell_starts;
+    m_RoomGrid.is_valid = true;
+}
+
+static bool M_IsInRoom(
+    const ROOM *const room, const int32_t x, const int32_t y, const int32_t z)
+{
+    const int32_t x1 = room->pos.x + WALL_L;
+    const int32_t x2 = room->pos.x + (room->size.x - 1) * WALL_L;
+    const int32_t y1 = room->max_ceiling;
+    const int32_t y2 = room->min_floor;
+    const int32_t z1 = room->pos.z + WALL_L;
+    const int32_t z2 = room->pos.z + (room->size.z - 1) * WALL_L;
+    return x >= x1 && x < x2 && y >= y1 && y <= y2 && z >= z1 && z < z2;
+}
+
 void Room_InitialiseRooms(const int32_t num_rooms)
 {
+    M_FreeRoomGrid();
     m_RoomCount = num_rooms;
     m_Rooms = num_rooms == 0
         ? nullptr
@@ -210,6 +336,8 @@ void Room_InitialiseFlipStatus(void)
     for (int32_t i = 0; i < MAX_FLIP_MAPS; i++) {
         m_FlipSlotFlags[i] = 0;
     }
+
+    M_BuildRoomGrid();
 }
 
 void Room_FlipMap(void)
@@ -241,6 +369,7 @@ void Room_FlipMap(void)
     }
 
     m_FlipStatus = !m_FlipStatus;
+    M_BuildRoomGrid();
 }
 
 bool Room_GetFlipStatus(void)
@@ -373,6 +502,11 @@ int32_t Room_GetAdjoiningRooms(
     return count;
 }
 
+void Room_RebuildGrid(void)
+{
+    M_BuildRoomGrid();
+}
+
 int16_t Room_GetIndexFromPos(const int32_t x, const int32_t y, const int32_t z)
 {
     // TODO: merge this to Room_FindByPos!
@@ -385,18 +519,33 @@ int16_t Room_GetIndexFromPos(const int32_t x, const int32_t y, const int32_t z)
 
 int32_t Room_FindByPos(const int32_t x, const int32_t y, const int32_t z)
 {
+    if (m_RoomGrid.is_valid) {
+        if (x < m_RoomGrid.min_x || z < m_RoomGrid.min_z) {
+            return NO_ROOM_NEG;
+        }
+        const int32_t cell_x = (x - m_RoomGrid.min_x) >> m_RoomGrid.shift;
+        const int32_t cell_z = (z - m_RoomGrid.min_z) >> m_RoomGrid.shift;
+        if (cell_x >= m_RoomGrid.size_x || cell_z >= m_RoomGrid.size_z) {
+            return NO_ROOM_NEG;
+        }
+        const int32_t cell = cell_z + cell_x * m_RoomGrid.size_z;
+        for (int32_t i = m_RoomGrid.cell_starts[cell];
+             i < m_RoomGrid.cell_starts[cell + 1]; i++) {
+            const int32_t room_num = m_RoomGrid.room_nums[i];
+            if (M_IsInRoom(&m_Rooms[room_num], x, y, z)) {
+                return room_num;
+            }
+        }
+        return NO_ROOM_NEG;
+    }
+
+    // The grid isn't available while a level is being loaded.
     for (int32_t i = 0; i < Room_GetCount(); i++) {
         const ROOM *const room = Room_Get(i);
         if (room->flip_status == RFS_FLIPPED) {
             continue;
         }
-        const int32_t x1 = room->pos.x + WALL_L;
-        const int32_t x2 = room->pos.x + (room->size.x - 1) * WALL_L;
-        const int32_t y1 = room->max_ceiling;
-        const int32_t y2 = room->min_floor;
-        const int32_t z1 = room->pos.z + WALL_L;
-        const int32_t z2 = room->pos.z + (room->size.z - 1) * WALL_L;
-        if (x >= x1 && x < x2 && y >= y1 && y <= y2 && z >= z1 && z < z2) {
+        if (M_IsInRoom(room, x, y, z)) {
             return i;
         }
     }
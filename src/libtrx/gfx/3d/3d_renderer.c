@@ -5,6 +5,15 @@
 #include "gfx/gl/utils.h"
 #include "log.h"
 #include "memory.h"
+#include "utils.h"
+
+#include <string.h>
+
+// texture arrays use their own unit, as a unit cannot be shared by samplers
+// of different types
+#define M_TEXTURE_ARRAY_UNIT 1
+// the near plane and the four edges of the clip rectangle
+#define M_MESH_CLIP_PLANES 6
 
 struct GFX_3D_RENDERER {
     const GFX_CONFIG *config;
@@ -15,10 +24,14 @@ struct GFX_3D_RENDERER {
 
     GFX_GL_TEXTURE *textures[GFX_MAX_TEXTURES];
     GFX_GL_TEXTURE *env_map_texture;
+    GFX_GL_TEXTURE *texture_array;
     int selected_texture_num;
     GFX_BLEND_MODE selected_blend_mode;
     bool alpha_point_discard;
     float alpha_threshold;
+    bool is_smoothing_enabled;
+    float brightness_multiplier;
+    GLfloat projection[4][4];
 
     // shader variable locations
     GLint loc_mat_projection;
@@ -28,12 +41,35 @@ struct GFX_3D_RENDERER {
     GLint loc_alpha_point_discard;
     GLint loc_alpha_threshold;
     GLint loc_brightness_multiplier;
+    GLint loc_texture_array;
+    GLint loc_texture_array_enabled;
+
+    // static geometry, transformed on the GPU by its own program
+    struct {
+        bool is_ready;
+        GFX_GL_PROGRAM program;
+        GFX_3D_MESH_BUFFER buffer;
+        GLint loc_mat_projection;
+        GLint loc_mat_view;
+        GLint loc_projection;
+        GLint loc_depth;
+        GLint loc_far_z;
+        GLint loc_clip_rect;
+        GLint loc_fog;
+        GLint loc_light_color;
+        GLint loc_snap_uvs;
+        GLint loc_smoothing_enabled;
+        GLint loc_alpha_point_discard;
+        GLint loc_alpha_threshold;
+        GLint loc_brightness_multiplier;
+    } mesh;
 };
 
 static void M_ApplyUniforms(GFX_3D_RENDERER *renderer);
 static void M_Flush(GFX_3D_RENDERER *renderer);
 static void M_SelectTextureImpl(GFX_3D_RENDERER *renderer, int texture_num);
 static void M_RestoreTexture(GFX_3D_RENDERER *const renderer);
+static void M_InitMeshes(GFX_3D_RENDERER *renderer);
 
 static void M_ApplyUniforms(GFX_3D_RENDERER *const renderer)
 {
@@ -84,6 +120,20 @@ static void M_SelectTextureImpl(
 {
     ASSERT(renderer != nullptr);
 
+    GFX_GL_Program_Bind(&renderer->program);
+    GFX_GL_Program_Uniform1i(
+        &renderer->program, renderer->loc_texture_array_enabled,
+        texture_num == GFX_TEXTURE_ARRAY && renderer->texture_array != nullptr);
+    if (texture_num == GFX_TEXTURE_ARRAY) {
+        if (renderer->texture_array != nullptr) {
+            glActiveTexture(GL_TEXTURE0 + M_TEXTURE_ARRAY_UNIT);
+            GFX_GL_Texture_Bind(renderer->texture_array);
+            glActiveTexture(GL_TEXTURE0);
+            GFX_GL_CheckError();
+        }
+        return;
+    }
+
     GFX_GL_TEXTURE *texture = nullptr;
     if (texture_num == GFX_ENV_MAP_TEXTURE) {
         texture = renderer->env_map_texture;
@@ -108,6 +158,57 @@ static void M_RestoreTexture(GFX_3D_RENDERER *const renderer)
     M_SelectTextureImpl(renderer, renderer->selected_texture_num);
 }
 
+static void M_InitMeshes(GFX_3D_RENDERER *const renderer)
+{
+    if (renderer->mesh.is_ready) {
+        return;
+    }
+
+    GFX_GL_PROGRAM *const program = &renderer->mesh.program;
+    GFX_GL_Program_Init(program);
+    GFX_GL_Program_AttachShader(
+        program, GL_VERTEX_SHADER, "shaders/3d_mesh.glsl",
+        renderer->config->backend);
+    GFX_GL_Program_AttachShader(
+        program, GL_FRAGMENT_SHADER, "shaders/3d_mesh.glsl",
+        renderer->config->backend);
+    GFX_GL_Program_FragmentData(program, "outColor");
+    GFX_GL_Program_Link(program);
+
+    renderer->mesh.loc_mat_projection =
+        GFX_GL_Program_UniformLocation(program, "matProjection");
+    renderer->mesh.loc_mat_view =
+        GFX_GL_Program_UniformLocation(program, "matView");
+    renderer->mesh.loc_projection =
+        GFX_GL_Program_UniformLocation(program, "projection");
+    renderer->mesh.loc_depth = GFX_GL_Program_UniformLocation(program, "depth");
+    renderer->mesh.loc_far_z = GFX_GL_Program_UniformLocation(program, "farZ");
+    renderer->mesh.loc_clip_rect =
+        GFX_GL_Program_UniformLocation(program, "clipRect");
+    renderer->mesh.loc_fog = GFX_GL_Program_UniformLocation(program, "fog");
+    renderer->mesh.loc_light_color =
+        GFX_GL_Program_UniformLocation(program, "lightColor");
+    renderer->mesh.loc_snap_uvs =
+        GFX_GL_Program_UniformLocation(program, "snapUVs");
+    renderer->mesh.loc_smoothing_enabled =
+        GFX_GL_Program_UniformLocation(program, "smoothingEnabled");
+    renderer->mesh.loc_alpha_point_discard =
+        GFX_GL_Program_UniformLocation(program, "alphaPointDiscard");
+    renderer->mesh.loc_alpha_threshold =
+        GFX_GL_Program_UniformLocation(program, "alphaThreshold");
+    renderer->mesh.loc_brightness_multiplier =
+        GFX_GL_Program_UniformLocation(program, "brightnessMultiplier");
+
+    GFX_GL_Program_Bind(program);
+    GFX_GL_Program_Uniform1i(
+        program, GFX_GL_Program_UniformLocation(program, "texArray"),
+        M_TEXTURE_ARRAY_UNIT);
+    GFX_GL_Program_Bind(&renderer->program);
+
+    GFX_3D_MeshBuffer_Init(&renderer->mesh.buffer);
+    renderer->mesh.is_ready = true;
+}
+
 GFX_3D_RENDERER *GFX_3D_Renderer_Create(void)
 {
     LOG_INFO("");
@@ -120,9 +221,11 @@ GFX_3D_RENDERER *GFX_3D_Renderer_Create(void)
     }
     renderer->alpha_point_discard = false;
     renderer->alpha_threshold = -1.0;
+    renderer->brightness_multiplier = 1.0f;
 
     GFX_GL_Sampler_Init(&renderer->sampler);
     GFX_GL_Sampler_Bind(&renderer->sampler, 0);
+    GFX_GL_Sampler_Bind(&renderer->sampler, M_TEXTURE_ARRAY_UNIT);
     GFX_GL_Sampler_Parameterf(
         &renderer->sampler, GL_TEXTURE_MAX_ANISOTROPY_EXT, 1);
     GFX_GL_Sampler_Parameteri(
@@ -154,8 +257,15 @@ GFX_3D_RENDERER *GFX_3D_Renderer_Create(void)
         GFX_GL_Program_UniformLocation(&renderer->program, "alphaThreshold");
     renderer->loc_brightness_multiplier = GFX_GL_Program_UniformLocation(
         &renderer->program, "brightnessMultiplier");
+    renderer->loc_texture_array =
+        GFX_GL_Program_UniformLocation(&renderer->program, "texArray");
+    renderer->loc_texture_array_enabled = GFX_GL_Program_UniformLocation(
+        &renderer->program, "textureArrayEnabled");
 
     GFX_GL_Program_Bind(&renderer->program);
+    GFX_GL_Program_Uniform1i(
+        &renderer->program, renderer->loc_texture_array,
+        M_TEXTURE_ARRAY_UNIT);
 
     GLfloat model_view[4][4] = {
         { +1.0f, +0.0f, +0.0f, +0.0f },
@@ -180,6 +290,11 @@ void GFX_3D_Renderer_Destroy(GFX_3D_RENDERER *const renderer)
     ASSERT(renderer != nullptr);
 
     GFX_3D_VertexStream_Close(&renderer->vertex_stream);
+    if (renderer->mesh.is_ready) {
+        GFX_3D_MeshBuffer_Close(&renderer->mesh.buffer);
+        GFX_GL_Program_Close(&renderer->mesh.program);
+    }
+    GFX_GL_Texture_Free(renderer->texture_array);
     GFX_GL_Program_Close(&renderer->program);
     GFX_GL_Sampler_Close(&renderer->sampler);
     Memory_Free(renderer);
@@ -195,6 +310,7 @@ void GFX_3D_Renderer_RenderBegin(GFX_3D_RENDERER *const renderer)
     GFX_GL_Program_Bind(&renderer->program);
     GFX_3D_VertexStream_Bind(&renderer->vertex_stream);
     GFX_GL_Sampler_Bind(&renderer->sampler, 0);
+    GFX_GL_Sampler_Bind(&renderer->sampler, M_TEXTURE_ARRAY_UNIT);
 
     M_RestoreTexture(renderer);
     M_ApplyUniforms(renderer);
@@ -203,13 +319,14 @@ void GFX_3D_Renderer_RenderBegin(GFX_3D_RENDERER *const renderer)
     const float top = 0.0f;
     const float right = GFX_Context_GetDisplayWidth();
     const float bottom = GFX_Context_GetDisplayHeight();
-    GLfloat projection[4][4] = {
+    const GLfloat projection[4][4] = {
         { 2.0f / (right - left), 0.0f, 0.0f, 0.0f },
         { 0.0f, 2.0f / (top - bottom), 0.0f, 0.0f },
         { 0.0f, 0.0f, 1.0f, 0.0f },
         { -(right + left) / (right - left), -(top + bottom) / (top - bottom),
           0.0f, 1.0f },
     };
+    memcpy(renderer->projection, projection, sizeof(projection));
 
     GFX_GL_Program_UniformMatrix4fv(
         &renderer->program, renderer->loc_mat_projection, 1, GL_FALSE,
@@ -242,6 +359,63 @@ void GFX_3D_Renderer_ClearDepth(GFX_3D_RENDERER *const renderer)
     GFX_GL_CheckError();
 }
 
+int GFX_3D_Renderer_RegisterTextureArray(
+    GFX_3D_RENDERER *const renderer, const void *const data, const int width,
+    const int height, const int layer_count)
+{
+    ASSERT(renderer != nullptr);
+    ASSERT(data != nullptr);
+    ASSERT(renderer->texture_array == nullptr);
+
+    // the GLSL 1.20 shader has no array samplers
+    if (renderer->config->backend != GFX_GL_33C) {
+        return GFX_NO_TEXTURE;
+    }
+
+    GLint max_layers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &max_layers);
+    GFX_GL_CheckError();
+    if (layer_count > max_layers) {
+        LOG_INFO(
+            "Too many texture pages for a texture array (%d > %d)",
+            layer_count, max_layers);
+        return GFX_NO_TEXTURE;
+    }
+
+    GFX_GL_TEXTURE *const texture = GFX_GL_Texture_Create(GL_TEXTURE_2D_ARRAY);
+    glActiveTexture(GL_TEXTURE0 + M_TEXTURE_ARRAY_UNIT);
+    GFX_GL_Texture_LoadArray(
+        texture, data, width, height, layer_count, GL_RGBA, GL_RGBA);
+    glActiveTexture(GL_TEXTURE0);
+    GFX_GL_CheckError();
+    renderer->texture_array = texture;
+
+    M_RestoreTexture(renderer);
+    return GFX_TEXTURE_ARRAY;
+}
+
+bool GFX_3D_Renderer_UnregisterTextureArray(
+    GFX_3D_RENDERER *const renderer, const int texture_num)
+{
+    ASSERT(renderer != nullptr);
+
+    GFX_GL_TEXTURE *const texture = renderer->texture_array;
+    if (texture == nullptr || texture_num != GFX_TEXTURE_ARRAY) {
+        LOG_ERROR("Invalid texture array handle");
+        return false;
+    }
+
+    // unbind texture if currently bound
+    if (renderer->selected_texture_num == texture_num) {
+        M_SelectTextureImpl(renderer, GFX_NO_TEXTURE);
+        renderer->selected_texture_num = GFX_NO_TEXTURE;
+    }
+
+    GFX_GL_Texture_Free(texture);
+    renderer->texture_array = nullptr;
+    return true;
+}
+
 int GFX_3D_Renderer_RegisterEnvironmentMap(GFX_3D_RENDERER *const renderer)
 {
     ASSERT(renderer != nullptr);
@@ -377,6 +551,139 @@ void GFX_3D_Renderer_SelectTexture(
     M_SelectTextureImpl(renderer, texture_num);
 }
 
+bool GFX_3D_Renderer_UploadMeshes(
+    GFX_3D_RENDERER *const renderer, const GFX_3D_MESH_VERTEX *const vertices,
+    const int vertex_count, const uint32_t *const indices,
+    const int index_count)
+{
+    ASSERT(renderer != nullptr);
+    GFX_3D_Renderer_ReleaseMeshes(renderer);
+    if (renderer->texture_array == nullptr || index_count <= 0) {
+        return false;
+    }
+
+    M_InitMeshes(renderer);
+    GFX_3D_MeshBuffer_Upload(
+        &renderer->mesh.buffer, vertices, vertex_count, indices, index_count);
+    LOG_INFO(
+        "Uploaded static meshes: %d vertices, %d indices", vertex_count,
+        index_count);
+    return true;
+}
+
+void GFX_3D_Renderer_ReleaseMeshes(GFX_3D_RENDERER *const renderer)
+{
+    ASSERT(renderer != nullptr);
+    if (renderer->mesh.is_ready) {
+        GFX_3D_MeshBuffer_Release(&renderer->mesh.buffer);
+    }
+}
+
+bool GFX_3D_Renderer_HasMeshes(const GFX_3D_RENDERER *const renderer)
+{
+    ASSERT(renderer != nullptr);
+    return renderer->mesh.is_ready && renderer->mesh.buffer.is_loaded
+        && renderer->texture_array != nullptr;
+}
+
+void GFX_3D_Renderer_UpdateMeshVertices(
+    GFX_3D_RENDERER *const renderer, const int first_vertex,
+    const GFX_3D_MESH_VERTEX *const vertices, const int vertex_count)
+{
+    ASSERT(renderer != nullptr);
+    if (!GFX_3D_Renderer_HasMeshes(renderer)) {
+        return;
+    }
+    GFX_3D_MeshBuffer_UpdateVertices(
+        &renderer->mesh.buffer, first_vertex, vertices, vertex_count);
+}
+
+void GFX_3D_Renderer_DrawMesh(
+    GFX_3D_RENDERER *const renderer, const GFX_3D_MESH_PARAMS *const params,
+    const int first_index, const int index_count)
+{
+    ASSERT(renderer != nullptr);
+    ASSERT(params != nullptr);
+    if (!GFX_3D_Renderer_HasMeshes(renderer) || index_count <= 0) {
+        return;
+    }
+
+    // keep the draw order of the streamed geometry
+    M_Flush(renderer);
+
+    GFX_GL_PROGRAM *const program = &renderer->mesh.program;
+    GFX_GL_Program_Bind(program);
+
+    const GLfloat view[4][4] = {
+        { params->matrix[0][0], params->matrix[0][1], params->matrix[0][2],
+          params->matrix[0][3] },
+        { params->matrix[1][0], params->matrix[1][1], params->matrix[1][2],
+          params->matrix[1][3] },
+        { params->matrix[2][0], params->matrix[2][1], params->matrix[2][2],
+          params->matrix[2][3] },
+        { 0.0f, 0.0f, 0.0f, 1.0f },
+    };
+    GFX_GL_Program_UniformMatrix4fv(
+        program, renderer->mesh.loc_mat_projection, 1, GL_FALSE,
+        &renderer->projection[0][0]);
+    GFX_GL_Program_UniformMatrix4fv(
+        program, renderer->mesh.loc_mat_view, 1, GL_TRUE, &view[0][0]);
+    GFX_GL_Program_Uniform3f(
+        program, renderer->mesh.loc_projection, params->center_x,
+        params->center_y, params->persp);
+    GFX_GL_Program_Uniform3f(
+        program, renderer->mesh.loc_depth, params->depth_base,
+        params->depth_scale, params->near_z);
+    GFX_GL_Program_Uniform1f(program, renderer->mesh.loc_far_z, params->far_z);
+    GFX_GL_Program_Uniform4f(
+        program, renderer->mesh.loc_clip_rect, params->clip.min_x,
+        params->clip.min_y, params->clip.max_x, params->clip.max_y);
+    GFX_GL_Program_Uniform3f(
+        program, renderer->mesh.loc_fog, params->fog_begin,
+        MAX(params->fog_end, params->fog_begin + 1.0f), params->max_shade);
+    GFX_GL_Program_Uniform3f(
+        program, renderer->mesh.loc_light_color, params->color[0],
+        params->color[1], params->color[2]);
+    GFX_GL_Program_Uniform1i(
+        program, renderer->mesh.loc_snap_uvs, params->snap_uvs);
+    GFX_GL_Program_Uniform1i(
+        program, renderer->mesh.loc_smoothing_enabled,
+        renderer->is_smoothing_enabled);
+    GFX_GL_Program_Uniform1f(
+        program, renderer->mesh.loc_alpha_threshold,
+        renderer->config->enable_wireframe ? -1.0f : renderer->alpha_threshold);
+    GFX_GL_Program_Uniform1i(
+        program, renderer->mesh.loc_alpha_point_discard,
+        !renderer->config->enable_wireframe && renderer->alpha_point_discard);
+    GFX_GL_Program_Uniform1f(
+        program, renderer->mesh.loc_brightness_multiplier,
+        renderer->brightness_multiplier);
+
+    glActiveTexture(GL_TEXTURE0 + M_TEXTURE_ARRAY_UNIT);
+    GFX_GL_Texture_Bind(renderer->texture_array);
+    glActiveTexture(GL_TEXTURE0);
+
+    // the projection flips the Y axis, so visible faces wind clockwise
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    glFrontFace(GL_CW);
+    for (int i = 0; i < M_MESH_CLIP_PLANES; i++) {
+        glEnable(GL_CLIP_DISTANCE0 + i);
+    }
+    GFX_GL_CheckError();
+
+    GFX_3D_MeshBuffer_Draw(&renderer->mesh.buffer, first_index, index_count);
+
+    for (int i = 0; i < M_MESH_CLIP_PLANES; i++) {
+        glDisable(GL_CLIP_DISTANCE0 + i);
+    }
+    glDisable(GL_CULL_FACE);
+    GFX_GL_CheckError();
+
+    GFX_GL_Program_Bind(&renderer->program);
+    M_RestoreTexture(renderer);
+}
+
 void GFX_3D_Renderer_SetPrimType(
     GFX_3D_RENDERER *const renderer, GFX_3D_PRIM_TYPE value)
 {
@@ -396,6 +703,7 @@ void GFX_3D_Renderer_SetTextureFilter(
     GFX_GL_Sampler_Parameteri(
         &renderer->sampler, GL_TEXTURE_MIN_FILTER,
         filter == GFX_TF_BILINEAR ? GL_LINEAR : GL_NEAREST);
+    renderer->is_smoothing_enabled = filter == GFX_TF_BILINEAR;
     GFX_GL_Program_Bind(&renderer->program);
     GFX_GL_Program_Uniform1i(
         &renderer->program, renderer->loc_smoothing_enabled,
@@ -471,6 +779,7 @@ void GFX_3D_Renderer_SetBrightnessMultiplier(
 {
     ASSERT(renderer != nullptr);
     M_Flush(renderer);
+    renderer->brightness_multiplier = value;
     GFX_GL_Program_Bind(&renderer->program);
     GFX_GL_Program_Uniform1f(
         &renderer->program, renderer->loc_brightness_multiplier, value);
@@ -0,0 +1,125 @@
+#include "gfx/3d/mesh_buffer.h"
+
+#include "debug.h"
+#include "gfx/gl/utils.h"
+
+#include <GL/glew.h>
+#include <stddef.h>
+#include <stdint.h>
+
+void GFX_3D_MeshBuffer_Init(GFX_3D_MESH_BUFFER *const mesh_buffer)
+{
+    ASSERT(mesh_buffer != nullptr);
+    mesh_buffer->is_loaded = false;
+    mesh_buffer->index_count = 0;
+
+    // The index buffer binding is part of the vertex array state, so the
+    // vertex array must be bound first.
+    GFX_GL_VertexArray_Init(&mesh_buffer->vtc_format);
+    GFX_GL_VertexArray_Bind(&mesh_buffer->vtc_format);
+    GFX_GL_Buffer_Init(&mesh_buffer->vertex_buffer, GL_ARRAY_BUFFER);
+    GFX_GL_Buffer_Init(&mesh_buffer->index_buffer, GL_ELEMENT_ARRAY_BUFFER);
+    GFX_GL_Buffer_Bind(&mesh_buffer->vertex_buffer);
+    GFX_GL_Buffer_Bind(&mesh_buffer->index_buffer);
+
+    GFX_GL_VertexArray_Attribute(
+        &mesh_buffer->vtc_format, 0, 3, GL_FLOAT, GL_FALSE,
+        sizeof(GFX_3D_MESH_VERTEX), offsetof(GFX_3D_MESH_VERTEX, x));
+    GFX_GL_VertexArray_Attribute(
+        &mesh_buffer->vtc_format, 1, 2, GL_FLOAT, GL_FALSE,
+        sizeof(GFX_3D_MESH_VERTEX), offsetof(GFX_3D_MESH_VERTEX, u));
+    GFX_GL_VertexArray_Attribute(
+        &mesh_buffer->vtc_format, 2, 1, GL_FLOAT, GL_FALSE,
+        sizeof(GFX_3D_MESH_VERTEX), offsetof(GFX_3D_MESH_VERTEX, layer));
+    GFX_GL_VertexArray_Attribute(
+        &mesh_buffer->vtc_format, 3, 1, GL_FLOAT, GL_FALSE,
+        sizeof(GFX_3D_MESH_VERTEX), offsetof(GFX_3D_MESH_VERTEX, shade));
+}
+
+void GFX_3D_MeshBuffer_Close(GFX_3D_MESH_BUFFER *const mesh_buffer)
+{
+    ASSERT(mesh_buffer != nullptr);
+    GFX_GL_VertexArray_Close(&mesh_buffer->vtc_format);
+    GFX_GL_Buffer_Close(&mesh_buffer->vertex_buffer);
+    GFX_GL_Buffer_Close(&mesh_buffer->index_buffer);
+    mesh_buffer->is_loaded = false;
+    mesh_buffer->index_count = 0;
+}
+
+void GFX_3D_MeshBuffer_Upload(
+    GFX_3D_MESH_BUFFER *const mesh_buffer,
+    const GFX_3D_MESH_VERTEX *const vertices, const int32_t vertex_count,
+    const uint32_t *const indices, const int32_t index_count)
+{
+    ASSERT(mesh_buffer != nullptr);
+    ASSERT(vertices != nullptr);
+    ASSERT(indices != nullptr);
+
+    GFX_GL_VertexArray_Bind(&mesh_buffer->vtc_format);
+    GFX_GL_Buffer_Bind(&mesh_buffer->vertex_buffer);
+    GFX_GL_Buffer_Data(
+        &mesh_buffer->vertex_buffer,
+        vertex_count * sizeof(GFX_3D_MESH_VERTEX), vertices, GL_STATIC_DRAW);
+    GFX_GL_Buffer_Bind(&mesh_buffer->index_buffer);
+    GFX_GL_Buffer_Data(
+        &mesh_buffer->index_buffer, index_count * sizeof(uint32_t), indices,
+        GL_STATIC_DRAW);
+
+    mesh_buffer->index_count = index_count;
+    mesh_buffer->is_loaded = true;
+}
+
+void GFX_3D_MeshBuffer_Release(GFX_3D_MESH_BUFFER *const mesh_buffer)
+{
+    ASSERT(mesh_buffer != nullptr);
+    if (!mesh_buffer->is_loaded) {
+        return;
+    }
+
+    // keep the buffer names, only drop their storage
+    GFX_GL_VertexArray_Bind(&mesh_buffer->vtc_format);
+    GFX_GL_Buffer_Bind(&mesh_buffer->vertex_buffer);
+    GFX_GL_Buffer_Data(
+        &mesh_buffer->vertex_buffer, 0, nullptr, GL_STATIC_DRAW);
+    GFX_GL_Buffer_Bind(&mesh_buffer->index_buffer);
+    GFX_GL_Buffer_Data(&mesh_buffer->index_buffer, 0, nullptr, GL_STATIC_DRAW);
+
+    mesh_buffer->index_count = 0;
+    mesh_buffer->is_loaded = false;
+}
+
+void GFX_3D_MeshBuffer_UpdateVertices(
+    GFX_3D_MESH_BUFFER *const mesh_buffer, const int32_t first_vertex,
+    const GFX_3D_MESH_VERTEX *const vertices, const int32_t vertex_count)
+{
+    ASSERT(mesh_buffer != nullptr);
+    ASSERT(mesh_buffer->is_loaded);
+    ASSERT(vertices != nullptr);
+    if (vertex_count <= 0) {
+        return;
+    }
+
+    GFX_GL_Buffer_Bind(&mesh_buffer->vertex_buffer);
+    GFX_GL_Buffer_SubData(
+        &mesh_buffer->vertex_buffer, first_vertex * sizeof(GFX_3D_MESH_VERTEX),
+        vertex_count * sizeof(GFX_3D_MESH_VERTEX), vertices);
+}
+
+void GFX_3D_MeshBuffer_Draw(
+    GFX_3D_MESH_BUFFER *const mesh_buffer, const int32_t first_index,
+    const int32_t index_count)
+{
+    ASSERT(mesh_buffer != nullptr);
+    ASSERT(mesh_buffer->is_loaded);
+    ASSERT(first_index >= 0);
+    ASSERT(first_index + index_count <= mesh_buffer->index_count);
+    if (index_count <= 0) {
+        return;
+    }
+
+    GFX_GL_VertexArray_Bind(&mesh_buffer->vtc_format);
+    glDrawElements(
+        GL_TRIANGLES, index_count, GL_UNSIGNED_INT,
+        (const void *)(intptr_t)(first_index * sizeof(uint32_t)));
+    GFX_GL_CheckError();
+}
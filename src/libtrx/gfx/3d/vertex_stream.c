@@ -1,57 +1,107 @@
 #include "gfx/3d/vertex_stream.h"
 
+#include "debug.h"
 #include "gfx/gl/utils.h"
 #include "log.h"
 #include "memory.h"
+#include "utils.h"
 
 #include <GL/glew.h>
+#include <stdint.h>
+#include <string.h>
 
 #define M_PREALLOC_VERTEX_COUNT 8000
+#define M_PREALLOC_INDEX_COUNT 12000
+#define M_MAX_PENDING_VERTICES 0x10000
+#define M_SEGMENT_COUNT GFX_3D_VERTEX_STREAM_SEGMENTS
+#define M_FENCE_TIMEOUT 1000000000 // 1 second
+
+#if M_SEGMENT_COUNT < 2
+    #error "The stream buffers need at least two segments"
+#endif
 
 static const GLenum GL_PRIM_MODES[] = {
     GL_LINES, // GFX_3D_PRIM_LINE
     GL_TRIANGLES, // GFX_3D_PRIM_TRI
 };
 
-static void M_PushVertex(
-    GFX_3D_VERTEX_STREAM *vertex_stream, const GFX_3D_VERTEX *vertex);
+static uint16_t M_PushVertices(
+    GFX_3D_VERTEX_STREAM *vertex_stream, const GFX_3D_VERTEX *vertices,
+    int32_t count);
+static uint16_t *M_PushIndices(
+    GFX_3D_VERTEX_STREAM *vertex_stream, int32_t count);
+static bool M_IsPersistentMappingSupported(void);
+static void M_SetupFormat(GFX_3D_VERTEX_STREAM *vertex_stream);
+static void M_Buffer_Create(
+    GFX_3D_VERTEX_STREAM *vertex_stream, GFX_3D_STREAM_BUFFER *buf,
+    GLenum target, size_t segment_size);
+static void M_Buffer_Close(GFX_3D_STREAM_BUFFER *buf);
+static void M_Buffer_FenceSegment(GFX_3D_STREAM_BUFFER *buf, int32_t idx);
+static void M_Buffer_WaitSegment(GFX_3D_STREAM_BUFFER *buf, int32_t idx);
+static size_t M_Buffer_Reserve(
+    GFX_3D_VERTEX_STREAM *vertex_stream, GFX_3D_STREAM_BUFFER *buf,
+    size_t size, size_t limit);
+static void M_Buffer_Write(
+    GFX_3D_STREAM_BUFFER *buf, size_t offset, const void *data, size_t size);
 
-static void M_PushVertex(
+static uint16_t M_PushVertices(
     GFX_3D_VERTEX_STREAM *const vertex_stream,
-    const GFX_3D_VERTEX *const vertex)
+    const GFX_3D_VERTEX *const vertices, const int32_t count)
 {
-    if (vertex_stream->pending_vertices.count + 1
-        >= vertex_stream->pending_vertices.capacity) {
-        vertex_stream->pending_vertices.capacity += 1000;
+    ASSERT(count <= M_MAX_PENDING_VERTICES);
+    if (vertex_stream->pending_vertices.count + count
+        > M_MAX_PENDING_VERTICES) {
+        GFX_3D_VertexStream_RenderPending(vertex_stream);
+    }
+
+    const size_t needed = vertex_stream->pending_vertices.count + count;
+    if (needed > vertex_stream->pending_vertices.capacity) {
+        vertex_stream->pending_vertices.capacity =
+            MAX(needed, vertex_stream->pending_vertices.capacity * 2);
         vertex_stream->pending_vertices.data = Memory_Realloc(
             vertex_stream->pending_vertices.data,
             vertex_stream->pending_vertices.capacity * sizeof(GFX_3D_VERTEX));
     }
 
-    vertex_stream->pending_vertices
-        .data[vertex_stream->pending_vertices.count++] = *vertex;
+    const uint16_t first = vertex_stream->pending_vertices.count;
+    memcpy(
+        &vertex_stream->pending_vertices.data[first], vertices,
+        count * sizeof(GFX_3D_VERTEX));
+    vertex_stream->pending_vertices.count += count;
+    return first;
 }
 
-void GFX_3D_VertexStream_Init(GFX_3D_VERTEX_STREAM *const vertex_stream)
+static uint16_t *M_PushIndices(
+    GFX_3D_VERTEX_STREAM *const vertex_stream, const int32_t count)
 {
-    vertex_stream->prim_type = GFX_3D_PRIM_TRI;
-    vertex_stream->buffer_size =
-        M_PREALLOC_VERTEX_COUNT * sizeof(GFX_3D_VERTEX);
-    vertex_stream->rendered_count = 0;
-    vertex_stream->transferred = 0;
-    vertex_stream->pending_vertices.count = 0;
-    vertex_stream->pending_vertices.capacity = M_PREALLOC_VERTEX_COUNT;
-    vertex_stream->pending_vertices.data = Memory_Alloc(
-        vertex_stream->pending_vertices.capacity * sizeof(GFX_3D_VERTEX));
+    const size_t needed = vertex_stream->pending_indices.count + count;
+    if (needed > vertex_stream->pending_indices.capacity) {
+        vertex_stream->pending_indices.capacity =
+            MAX(needed, vertex_stream->pending_indices.capacity * 2);
+        vertex_stream->pending_indices.data = Memory_Realloc(
+            vertex_stream->pending_indices.data,
+            vertex_stream->pending_indices.capacity * sizeof(uint16_t));
+    }
 
-    GFX_GL_Buffer_Init(&vertex_stream->buffer, GL_ARRAY_BUFFER);
-    GFX_GL_Buffer_Bind(&vertex_stream->buffer);
-    GFX_GL_Buffer_Data(
-        &vertex_stream->buffer, vertex_stream->buffer_size, nullptr,
-        GL_STREAM_DRAW);
+    uint16_t *const indices = &vertex_stream->pending_indices
+                                   .data[vertex_stream->pending_indices.count];
+    vertex_stream->pending_indices.count += count;
+    return indices;
+}
 
-    GFX_GL_VertexArray_Init(&vertex_stream->vtc_format);
+static bool M_IsPersistentMappingSupported(void)
+{
+    return GLEW_ARB_buffer_storage
+        && (GLEW_VERSION_3_0 || GLEW_ARB_map_buffer_range)
+        && (GLEW_VERSION_3_2 || GLEW_ARB_sync);
+}
+
+static void M_SetupFormat(GFX_3D_VERTEX_STREAM *const vertex_stream)
+{
+    // The vertex format refers to the buffers that were bound when it was
+    // set up, so it has to follow them whenever they get replaced.
     GFX_GL_VertexArray_Bind(&vertex_stream->vtc_format);
+    GFX_GL_Buffer_Bind(&vertex_stream->vertex_buffer.buffer);
     GFX_GL_VertexArray_Attribute(
         &vertex_stream->vtc_format, 0, 3, GL_FLOAT, GL_FALSE,
         sizeof(GFX_3D_VERTEX), offsetof(GFX_3D_VERTEX, x));
@@ -61,20 +111,197 @@ void GFX_3D_VertexStream_Init(GFX_3D_VERTEX_STREAM *const vertex_stream)
     GFX_GL_VertexArray_Attribute(
         &vertex_stream->vtc_format, 2, 4, GL_FLOAT, GL_FALSE,
         sizeof(GFX_3D_VERTEX), offsetof(GFX_3D_VERTEX, r));
+    GFX_GL_VertexArray_Attribute(
+        &vertex_stream->vtc_format, 3, 1, GL_FLOAT, GL_FALSE,
+        sizeof(GFX_3D_VERTEX), offsetof(GFX_3D_VERTEX, layer));
+    GFX_GL_Buffer_Bind(&vertex_stream->index_buffer.buffer);
+    GFX_GL_CheckError();
+}
+
+static void M_Buffer_Create(
+    GFX_3D_VERTEX_STREAM *const vertex_stream,
+    GFX_3D_STREAM_BUFFER *const buf, const GLenum target,
+    const size_t segment_size)
+{
+    buf->segment_size = segment_size;
+    buf->size = segment_size * M_SEGMENT_COUNT;
+    buf->offset = 0;
+    buf->map = nullptr;
+    for (int32_t i = 0; i < M_SEGMENT_COUNT; i++) {
+        buf->fences[i] = nullptr;
+    }
+
+    // the index buffer binding is a part of the vertex array state
+    GFX_GL_VertexArray_Bind(&vertex_stream->vtc_format);
+    GFX_GL_Buffer_Init(&buf->buffer, target);
+    GFX_GL_Buffer_Bind(&buf->buffer);
+    if (buf->is_persistent) {
+        // Persistent storage is immutable, so growing it means creating
+        // a new buffer.
+        const GLbitfield flags =
+            GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GFX_GL_Buffer_Storage(&buf->buffer, buf->size, nullptr, flags);
+        buf->map = GFX_GL_Buffer_MapRange(&buf->buffer, 0, buf->size, flags);
+        if (buf->map == nullptr) {
+            LOG_ERROR("Failed to map the stream buffer, falling back");
+            buf->is_persistent = false;
+            GFX_GL_Buffer_Close(&buf->buffer);
+            M_Buffer_Create(vertex_stream, buf, target, segment_size);
+            return;
+        }
+    } else {
+        GFX_GL_Buffer_Data(&buf->buffer, buf->size, nullptr, GL_STREAM_DRAW);
+    }
+}
 
+static void M_Buffer_Close(GFX_3D_STREAM_BUFFER *const buf)
+{
+    for (int32_t i = 0; i < M_SEGMENT_COUNT; i++) {
+        if (buf->fences[i] != nullptr) {
+            glDeleteSync(buf->fences[i]);
+            buf->fences[i] = nullptr;
+        }
+    }
+    GFX_GL_Buffer_Close(&buf->buffer);
+    buf->map = nullptr;
+}
+
+static void M_Buffer_FenceSegment(
+    GFX_3D_STREAM_BUFFER *const buf, const int32_t idx)
+{
+    if (buf->fences[idx] != nullptr) {
+        glDeleteSync(buf->fences[idx]);
+    }
+    buf->fences[idx] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
     GFX_GL_CheckError();
 }
 
+static void M_Buffer_WaitSegment(
+    GFX_3D_STREAM_BUFFER *const buf, const int32_t idx)
+{
+    GLsync fence = buf->fences[idx];
+    if (fence == nullptr) {
+        return;
+    }
+
+    // This only blocks if the GPU lags behind by the whole ring.
+    GLenum result;
+    do {
+        result = glClientWaitSync(
+            fence, GL_SYNC_FLUSH_COMMANDS_BIT, M_FENCE_TIMEOUT);
+    } while (result == GL_TIMEOUT_EXPIRED);
+    if (result == GL_WAIT_FAILED) {
+        GFX_GL_CheckError();
+    }
+
+    glDeleteSync(fence);
+    buf->fences[idx] = nullptr;
+}
+
+static size_t M_Buffer_Reserve(
+    GFX_3D_VERTEX_STREAM *const vertex_stream, GFX_3D_STREAM_BUFFER *const buf,
+    const size_t size, const size_t limit)
+{
+    if (size > buf->segment_size) {
+        const size_t segment_size = MAX(size, buf->segment_size * 2);
+        LOG_INFO(
+            "Stream buffer resize: %zu -> %zu", buf->size,
+            segment_size * M_SEGMENT_COUNT);
+        const GLenum target = buf->buffer.target;
+        M_Buffer_Close(buf);
+        M_Buffer_Create(vertex_stream, buf, target, segment_size);
+        M_SetupFormat(vertex_stream);
+    }
+
+    // Never write over data that a queued draw call may still read.
+    // Instead, move on to the next segment and make sure that the GPU is
+    // done with it. The reserved range must also end within the limit.
+    size_t offset = buf->offset;
+    const int32_t segment = offset == 0 ? 0 : (offset - 1) / buf->segment_size;
+    if (offset + size > (segment + 1) * buf->segment_size
+        || offset + size > limit) {
+        int32_t next_segment = (segment + 1) % M_SEGMENT_COUNT;
+        if (next_segment * buf->segment_size + size > limit) {
+            next_segment = 0;
+        }
+        if (buf->is_persistent) {
+            // Waiting on the segment that was just fenced would stall until
+            // the GPU caught up with everything queued so far.
+            ASSERT(next_segment != segment);
+            M_Buffer_FenceSegment(buf, segment);
+            M_Buffer_WaitSegment(buf, next_segment);
+        } else if (next_segment == 0) {
+            // orphan the buffer, letting the driver hand out fresh memory
+            GFX_GL_Buffer_Data(
+                &buf->buffer, buf->size, nullptr, GL_STREAM_DRAW);
+        }
+        offset = next_segment * buf->segment_size;
+    }
+
+    buf->offset = offset + size;
+    return offset;
+}
+
+static void M_Buffer_Write(
+    GFX_3D_STREAM_BUFFER *const buf, const size_t offset,
+    const void *const data, const size_t size)
+{
+    if (buf->is_persistent) {
+        memcpy((char *)buf->map + offset, data, size);
+    } else {
+        GFX_GL_Buffer_SubData(&buf->buffer, offset, size, data);
+    }
+}
+
+void GFX_3D_VertexStream_Init(GFX_3D_VERTEX_STREAM *const vertex_stream)
+{
+    const bool is_persistent = M_IsPersistentMappingSupported();
+    vertex_stream->prim_type = GFX_3D_PRIM_TRI;
+    vertex_stream->has_base_vertex =
+        GLEW_VERSION_3_2 || GLEW_ARB_draw_elements_base_vertex;
+    // Without base vertex support, every vertex range has to start in the
+    // first segment to stay within reach of 16-bit indices, so a ring would
+    // wait on the GPU at every wrap. Orphaning the buffer avoids that.
+    vertex_stream->vertex_buffer.is_persistent =
+        is_persistent && vertex_stream->has_base_vertex;
+    vertex_stream->index_buffer.is_persistent = is_persistent;
+    vertex_stream->rendered_count = 0;
+    vertex_stream->transferred = 0;
+    vertex_stream->pending_vertices.count = 0;
+    vertex_stream->pending_vertices.capacity = M_PREALLOC_VERTEX_COUNT;
+    vertex_stream->pending_vertices.data = Memory_Alloc(
+        vertex_stream->pending_vertices.capacity * sizeof(GFX_3D_VERTEX));
+    vertex_stream->pending_indices.count = 0;
+    vertex_stream->pending_indices.capacity = M_PREALLOC_INDEX_COUNT;
+    vertex_stream->pending_indices.data = Memory_Alloc(
+        vertex_stream->pending_indices.capacity * sizeof(uint16_t));
+
+    GFX_GL_VertexArray_Init(&vertex_stream->vtc_format);
+    M_Buffer_Create(
+        vertex_stream, &vertex_stream->vertex_buffer, GL_ARRAY_BUFFER,
+        M_PREALLOC_VERTEX_COUNT * sizeof(GFX_3D_VERTEX));
+    M_Buffer_Create(
+        vertex_stream, &vertex_stream->index_buffer, GL_ELEMENT_ARRAY_BUFFER,
+        M_PREALLOC_INDEX_COUNT * sizeof(uint16_t));
+    M_SetupFormat(vertex_stream);
+    LOG_INFO(
+        "Vertex buffer mode: %s",
+        vertex_stream->vertex_buffer.is_persistent ? "persistent"
+                                                   : "orphaning");
+}
+
 void GFX_3D_VertexStream_Close(GFX_3D_VERTEX_STREAM *const vertex_stream)
 {
     GFX_GL_VertexArray_Close(&vertex_stream->vtc_format);
-    GFX_GL_Buffer_Close(&vertex_stream->buffer);
+    M_Buffer_Close(&vertex_stream->vertex_buffer);
+    M_Buffer_Close(&vertex_stream->index_buffer);
     Memory_FreePointer(&vertex_stream->pending_vertices.data);
+    Memory_FreePointer(&vertex_stream->pending_indices.data);
 }
 
 void GFX_3D_VertexStream_Bind(GFX_3D_VERTEX_STREAM *const vertex_stream)
 {
-    GFX_GL_Buffer_Bind(&vertex_stream->buffer);
+    GFX_GL_Buffer_Bind(&vertex_stream->vertex_buffer.buffer);
 }
 
 void GFX_3D_VertexStream_SetPrimType(
@@ -91,18 +318,17 @@ bool GFX_3D_VertexStream_PushPrimStrip(
         LOG_ERROR("Unsupported prim type: %d", vertex_stream->prim_type);
         return false;
     }
+    if (count < 3) {
+        return true;
+    }
 
-    if (count <= 2) {
-        for (int i = 0; i < count; i++) {
-            M_PushVertex(vertex_stream, &vertices[i]);
-        }
-    } else {
-        // convert strip to raw triangles
-        for (int i = 2; i < count; i++) {
-            M_PushVertex(vertex_stream, &vertices[i - 2]);
-            M_PushVertex(vertex_stream, &vertices[i - 1]);
-            M_PushVertex(vertex_stream, &vertices[i]);
-        }
+    // index the strip as separate triangles
+    const uint16_t first = M_PushVertices(vertex_stream, vertices, count);
+    uint16_t *indices = M_PushIndices(vertex_stream, (count - 2) * 3);
+    for (int i = 2; i < count; i++) {
+        *indices++ = first + i - 2;
+        *indices++ = first + i - 1;
+        *indices++ = first + i;
     }
 
     return true;
@@ -116,18 +342,17 @@ bool GFX_3D_VertexStream_PushPrimFan(
         LOG_ERROR("Unsupported prim type: %d", vertex_stream->prim_type);
         return false;
     }
+    if (count < 3) {
+        return true;
+    }
 
-    if (count <= 2) {
-        for (int i = 0; i < count; i++) {
-            M_PushVertex(vertex_stream, &vertices[i]);
-        }
-    } else {
-        // convert fan to raw triangles
-        for (int i = 2; i < count; i++) {
-            M_PushVertex(vertex_stream, &vertices[0]);
-            M_PushVertex(vertex_stream, &vertices[i - 1]);
-            M_PushVertex(vertex_stream, &vertices[i]);
-        }
+    // index the fan as separate triangles
+    const uint16_t first = M_PushVertices(vertex_stream, vertices, count);
+    uint16_t *indices = M_PushIndices(vertex_stream, (count - 2) * 3);
+    for (int i = 2; i < count; i++) {
+        *indices++ = first;
+        *indices++ = first + i - 1;
+        *indices++ = first + i;
     }
 
     return true;
@@ -137,8 +362,14 @@ bool GFX_3D_VertexStream_PushPrimList(
     GFX_3D_VERTEX_STREAM *const vertex_stream,
     const GFX_3D_VERTEX *const vertices, const int count)
 {
+    if (count <= 0) {
+        return true;
+    }
+
+    const uint16_t first = M_PushVertices(vertex_stream, vertices, count);
+    uint16_t *indices = M_PushIndices(vertex_stream, count);
     for (int i = 0; i < count; i++) {
-        M_PushVertex(vertex_stream, &vertices[i]);
+        *indices++ = first + i;
     }
     return true;
 }
@@ -146,36 +377,56 @@ bool GFX_3D_VertexStream_PushPrimList(
 void GFX_3D_VertexStream_RenderPending(
     GFX_3D_VERTEX_STREAM *const vertex_stream)
 {
-    if (!vertex_stream->pending_vertices.count) {
+    if (!vertex_stream->pending_indices.count) {
+        vertex_stream->pending_vertices.count = 0;
         return;
     }
 
-    GFX_GL_Buffer_Bind(&vertex_stream->buffer);
     GFX_GL_VertexArray_Bind(&vertex_stream->vtc_format);
+    GFX_GL_Buffer_Bind(&vertex_stream->vertex_buffer.buffer);
 
-    // resize GPU buffer if required
-    size_t buffer_size =
+    // Without base vertex support, the indices point straight into the
+    // vertex buffer, so the vertices must be placed within their 16-bit
+    // reach.
+    const size_t vertex_size =
         sizeof(GFX_3D_VERTEX) * vertex_stream->pending_vertices.count;
-    if (buffer_size > vertex_stream->buffer_size) {
-        LOG_INFO(
-            "Vertex buffer resize: %d -> %d", vertex_stream->buffer_size,
-            buffer_size);
-        GFX_GL_Buffer_Data(
-            &vertex_stream->buffer, buffer_size, nullptr, GL_STREAM_DRAW);
-        vertex_stream->buffer_size = buffer_size;
-        vertex_stream->transferred += buffer_size;
-    }
-
-    GFX_GL_Buffer_SubData(
-        &vertex_stream->buffer, 0, buffer_size,
-        vertex_stream->pending_vertices.data);
-    vertex_stream->transferred += buffer_size;
-
-    glDrawArrays(
-        GL_PRIM_MODES[vertex_stream->prim_type], 0,
-        vertex_stream->pending_vertices.count);
+    const size_t vertex_offset = M_Buffer_Reserve(
+        vertex_stream, &vertex_stream->vertex_buffer, vertex_size,
+        vertex_stream->has_base_vertex
+            ? SIZE_MAX
+            : M_MAX_PENDING_VERTICES * sizeof(GFX_3D_VERTEX));
+    M_Buffer_Write(
+        &vertex_stream->vertex_buffer, vertex_offset,
+        vertex_stream->pending_vertices.data, vertex_size);
+
+    const GLint base_vertex = vertex_offset / sizeof(GFX_3D_VERTEX);
+    if (!vertex_stream->has_base_vertex) {
+        for (size_t i = 0; i < vertex_stream->pending_indices.count; i++) {
+            vertex_stream->pending_indices.data[i] += base_vertex;
+        }
+    }
+
+    const size_t index_size =
+        sizeof(uint16_t) * vertex_stream->pending_indices.count;
+    const size_t index_offset = M_Buffer_Reserve(
+        vertex_stream, &vertex_stream->index_buffer, index_size, SIZE_MAX);
+    M_Buffer_Write(
+        &vertex_stream->index_buffer, index_offset,
+        vertex_stream->pending_indices.data, index_size);
+    vertex_stream->transferred += vertex_size + index_size;
+
+    const GLenum mode = GL_PRIM_MODES[vertex_stream->prim_type];
+    const GLsizei count = vertex_stream->pending_indices.count;
+    const void *const indices = (const void *)(intptr_t)index_offset;
+    if (vertex_stream->has_base_vertex) {
+        glDrawElementsBaseVertex(
+            mode, count, GL_UNSIGNED_SHORT, (void *)indices, base_vertex);
+    } else {
+        glDrawElements(mode, count, GL_UNSIGNED_SHORT, indices);
+    }
     GFX_GL_CheckError();
 
-    vertex_stream->rendered_count += vertex_stream->pending_vertices.count;
+    vertex_stream->rendered_count += vertex_stream->pending_indices.count;
     vertex_stream->pending_vertices.count = 0;
+    vertex_stream->pending_indices.count = 0;
 }
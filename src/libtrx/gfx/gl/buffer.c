@@ -48,6 +48,15 @@ void GFX_GL_Buffer_SubData(
     GFX_GL_CheckError();
 }
 
+void GFX_GL_Buffer_Storage(
+    GFX_GL_BUFFER *buf, GLsizeiptr size, const void *data, GLbitfield flags)
+{
+    ASSERT(buf != nullptr);
+    ASSERT(buf->initialized);
+    glBufferStorage(buf->target, size, data, flags);
+    GFX_GL_CheckError();
+}
+
 void *GFX_GL_Buffer_Map(GFX_GL_BUFFER *buf, GLenum access)
 {
     ASSERT(buf != nullptr);
@@ -57,6 +66,16 @@ void *GFX_GL_Buffer_Map(GFX_GL_BUFFER *buf, GLenum access)
     return ret;
 }
 
+void *GFX_GL_Buffer_MapRange(
+    GFX_GL_BUFFER *buf, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    ASSERT(buf != nullptr);
+    ASSERT(buf->initialized);
+    void *ret = glMapBufferRange(buf->target, offset, length, access);
+    GFX_GL_CheckError();
+    return ret;
+}
+
 void GFX_GL_Buffer_Unmap(GFX_GL_BUFFER *buf)
 {
     ASSERT(buf != nullptr);
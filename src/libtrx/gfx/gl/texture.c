@@ -67,6 +67,28 @@ void GFX_GL_Texture_Load(
     GFX_GL_CheckError();
 }
 
+void GFX_GL_Texture_LoadArray(
+    GFX_GL_TEXTURE *const texture, const void *const data, const int width,
+    const int height, const int layer_count, const GLint internal_format,
+    const GLint format)
+{
+    ASSERT(texture != nullptr);
+    ASSERT(texture->initialized);
+    ASSERT(texture->target == GL_TEXTURE_2D_ARRAY);
+
+    GFX_GL_Texture_Bind(texture);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage3D(
+        GL_TEXTURE_2D_ARRAY, 0, internal_format, width, height, layer_count, 0,
+        format, GL_UNSIGNED_BYTE, data);
+    GFX_GL_CheckError();
+
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    GFX_GL_CheckError();
+}
+
 void GFX_GL_Texture_LoadFromBackBuffer(GFX_GL_TEXTURE *const texture)
 {
     ASSERT(texture != nullptr);
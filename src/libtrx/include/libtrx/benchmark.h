@@ -2,11 +2,40 @@
 
 #include <SDL2/SDL_stdinc.h>
 
+// Number of frames kept in the zone profiler history ring buffer.
+#define BENCHMARK_MAX_FRAMES 1024
+
 typedef struct {
     Uint64 start;
     Uint64 last;
 } BENCHMARK;
 
+// Static zone identifiers for the frame profiler. Zones can nest; each zone
+// remembers the zone it was first opened in as its parent.
+typedef enum {
+    BENCHMARK_ZONE_FRAME,
+    BENCHMARK_ZONE_CONTROL,
+    BENCHMARK_ZONE_ITEM_CONTROL,
+    BENCHMARK_ZONE_DRAW,
+    BENCHMARK_ZONE_DRAW_ROOMS,
+    BENCHMARK_ZONE_SORT_POLY_LIST,
+    BENCHMARK_ZONE_DRAW_POLY_LIST,
+    BENCHMARK_ZONE_AUDIO_MIX,
+    BENCHMARK_ZONE_NUMBER_OF,
+} BENCHMARK_ZONE;
+
+// Timings are in milliseconds and only consider frames in which the zone was
+// entered at least once.
+typedef struct {
+    const char *parent; // nullptr for root zones
+    int32_t frames;
+    double calls;
+    double min;
+    double avg;
+    double p99;
+    double max;
+} BENCHMARK_ZONE_STATS;
+
 BENCHMARK *Benchmark_Start(void);
 
 #define Benchmark_End(b, ...)                                                  \
@@ -22,3 +51,21 @@ void Benchmark_End_Impl(
 void Benchmark_Tick_Impl(
     BENCHMARK *b, const char *file, int32_t line, const char *func,
     const char *message);
+
+// Zone profiler. All of these are cheap no-ops unless profiling is enabled.
+void Benchmark_SetProfiling(bool enable);
+bool Benchmark_IsProfiling(void);
+void Benchmark_ResetZones(void);
+
+void Benchmark_BeginFrame(void);
+void Benchmark_EndFrame(void);
+int32_t Benchmark_GetFrameCount(void);
+void Benchmark_BeginZone(BENCHMARK_ZONE zone);
+void Benchmark_EndZone(BENCHMARK_ZONE zone);
+
+const char *Benchmark_GetZoneName(BENCHMARK_ZONE zone);
+bool Benchmark_GetZoneStats(BENCHMARK_ZONE zone, BENCHMARK_ZONE_STATS *stats);
+
+// Writes the aggregated zone statistics to the given path. The output is CSV
+// if the path ends with .csv, and JSON otherwise.
+bool Benchmark_DumpZones(const char *path);
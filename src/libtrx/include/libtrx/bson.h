@@ -28,3 +28,13 @@ const char *BSON_GetErrorDescription(BSON_PARSE_ERROR error);
 /* Write out a BSON binary string. Return 0 if an error occurred (malformed
  * JSON input, or malloc failed). The out_size parameter is optional. */
 void *BSON_Write(const JSON_VALUE *value, size_t *out_size);
+
+// Receives consecutive pieces of the BSON encoding. Returning false aborts the
+// write.
+typedef bool (*BSON_WRITE_FUNC)(const void *data, size_t size, void *user_data);
+
+// Write out the same encoding as BSON_Write, but pass it on to func in small
+// pieces rather than building it in a single buffer. Returns false if the
+// value could not be encoded or func failed.
+bool BSON_WriteStream(
+    const JSON_VALUE *value, BSON_WRITE_FUNC func, void *user_data);
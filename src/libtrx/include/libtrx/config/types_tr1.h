@@ -156,6 +156,7 @@ typedef struct {
         bool enable_wading;
         bool enable_game_modes;
         bool enable_save_crystals;
+        bool enable_async_saves;
         bool enable_uw_roll;
         bool enable_lean_jumping;
         bool enable_target_change;
@@ -12,6 +12,10 @@
 bool Audio_Init(void);
 bool Audio_Shutdown(void);
 
+// Prevents Audio_Init from opening an audio device, which turns all playback
+// into no-ops. Must be called before the first Audio_Init.
+void Audio_Disable(void);
+
 bool Audio_Stream_Pause(int32_t sound_id);
 bool Audio_Stream_Unpause(int32_t sound_id);
 int32_t Audio_Stream_CreateFromFile(const char *path);
@@ -8,6 +8,11 @@ void Clock_Init(void);
 void Clock_SyncTick(void);
 int32_t Clock_WaitTick(void);
 
+// In uncapped mode every tick yields exactly one frame without waiting, so the
+// game runs as fast as the host allows while staying deterministic.
+void Clock_SetUncapped(bool enable);
+bool Clock_IsUncapped(void);
+
 size_t Clock_GetDateTime(char *buffer, size_t size);
 
 int32_t Clock_GetFrameAdvance(void);
@@ -14,3 +14,11 @@ extern void Demo_StopFlashing(void);
 extern bool Demo_GetInput(void);
 extern GF_COMMAND Demo_Control(void);
 extern int32_t Demo_ChooseLevel(int32_t demo_num);
+
+// Headless benchmark mode, requested with -benchmark or -benchmark=N,M,...
+// Needs to parse the arguments before the shell sets up SDL.
+bool Demo_Benchmark_ParseArgs(int32_t arg_count, char **args);
+bool Demo_Benchmark_IsActive(void);
+GF_COMMAND Demo_Benchmark_Run(void);
+void Demo_Benchmark_Begin(int32_t demo_num);
+void Demo_Benchmark_End(void);
@@ -40,6 +40,7 @@ typedef enum {
     GBUF_OVERLAPS,
     GBUF_GROUND_ZONE,
     GBUF_FLY_ZONE,
+    GBUF_BOX_ADJACENCY,
     GBUF_ANIMATED_TEXTURE_RANGES,
     GBUF_CINEMATIC_FRAMES,
     GBUF_CREATURE_DATA,
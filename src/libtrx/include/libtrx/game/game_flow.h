@@ -2,6 +2,7 @@
 
 #include "./game_flow/common.h"
 #include "./game_flow/enum.h"
+#include "./game_flow/prefetch.h"
 #include "./game_flow/reader.h"
 #include "./game_flow/sequencer.h"
 #include "./game_flow/types.h"
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "./types.h"
+
+// Reads the level file and its injections on a background thread and throws
+// the data away, so that it is already in the OS file cache by the time the
+// level loads. Nothing is parsed ahead of time. Only one level is prefetched
+// at a time and a new request replaces the last.
+void GF_PrefetchLevel(const GF_LEVEL *level);
+// Stops reading and joins the thread. Level loading calls this first, as it
+// reads the same files itself from then on.
+void GF_CancelPrefetch(void);
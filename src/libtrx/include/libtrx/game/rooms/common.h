@@ -30,6 +30,8 @@ void Room_PopulateSectorData(
 
 int16_t Room_GetIndexFromPos(int32_t x, int32_t y, int32_t z);
 int32_t Room_FindByPos(int32_t x, int32_t y, int32_t z);
+// Must be called whenever room positions change outside of flipmaps.
+void Room_RebuildGrid(void);
 BOUNDS_32 Room_GetWorldBounds(void);
 
 SECTOR *Room_GetWorldSector(const ROOM *room, int32_t x_pos, int32_t z_pos);
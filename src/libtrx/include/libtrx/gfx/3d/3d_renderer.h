@@ -5,6 +5,7 @@
 #include "../gl/program.h"
 #include "../gl/sampler.h"
 #include "../gl/texture.h"
+#include "mesh_buffer.h"
 #include "vertex_stream.h"
 
 #include <GL/glew.h>
@@ -12,6 +13,7 @@
 #define GFX_MAX_TEXTURES 128
 #define GFX_NO_TEXTURE (-1)
 #define GFX_ENV_MAP_TEXTURE (-2)
+#define GFX_TEXTURE_ARRAY (-3)
 
 #include <stdint.h>
 
@@ -21,6 +23,35 @@ typedef enum {
     GFX_BLEND_MODE_MULTIPLY,
 } GFX_BLEND_MODE;
 
+// Describes how GFX_3D_Renderer_DrawMesh places and lights its vertices. It
+// mirrors the software pipeline: the matrix moves vertices to view space,
+// they are projected around the centre, and dimmed with distance by fog.
+typedef struct {
+    float matrix[3][4];
+    float center_x;
+    float center_y;
+    float persp;
+    float near_z;
+    // geometry beyond this view depth is clipped, unless it is zero
+    float far_z;
+    // depth = depth_base - depth_scale / z
+    float depth_base;
+    float depth_scale;
+    struct {
+        float min_x;
+        float min_y;
+        float max_x;
+        float max_y;
+    } clip;
+    float fog_begin;
+    float fog_end;
+    float max_shade;
+    // colour per unit of light that is left after shading and fog
+    float color[3];
+    // sample texel centres rather than the exact texture coordinates
+    bool snap_uvs;
+} GFX_3D_MESH_PARAMS;
+
 typedef struct GFX_3D_RENDERER GFX_3D_RENDERER;
 
 GFX_3D_RENDERER *GFX_3D_Renderer_Create(void);
@@ -36,6 +67,16 @@ int GFX_3D_Renderer_RegisterTexturePage(
 bool GFX_3D_Renderer_UnregisterTexturePage(
     GFX_3D_RENDERER *renderer, int texture_num);
 
+// Uploads texture pages of the same size as layers of a single array
+// texture. Selecting it lets the vertices pick their page through the layer
+// attribute, so page changes no longer need a flush. Returns GFX_NO_TEXTURE
+// if the backend has no texture array support.
+int GFX_3D_Renderer_RegisterTextureArray(
+    GFX_3D_RENDERER *renderer, const void *data, int width, int height,
+    int layer_count);
+bool GFX_3D_Renderer_UnregisterTextureArray(
+    GFX_3D_RENDERER *renderer, int texture_num);
+
 int GFX_3D_Renderer_RegisterEnvironmentMap(GFX_3D_RENDERER *renderer);
 bool GFX_3D_Renderer_UnregisterEnvironmentMap(
     GFX_3D_RENDERER *renderer, int texture_num);
@@ -43,6 +84,25 @@ void GFX_3D_Renderer_FillEnvironmentMap(GFX_3D_RENDERER *renderer);
 
 void GFX_3D_Renderer_SelectTexture(GFX_3D_RENDERER *renderer, int texture_num);
 
+// Uploads static geometry, replacing any earlier upload. The triangles sample
+// the registered texture array, so this returns false without one.
+bool GFX_3D_Renderer_UploadMeshes(
+    GFX_3D_RENDERER *renderer, const GFX_3D_MESH_VERTEX *vertices,
+    int vertex_count, const uint32_t *indices, int index_count);
+void GFX_3D_Renderer_ReleaseMeshes(GFX_3D_RENDERER *renderer);
+bool GFX_3D_Renderer_HasMeshes(const GFX_3D_RENDERER *renderer);
+// Replaces a part of the uploaded vertices, for example to animate textures.
+void GFX_3D_Renderer_UpdateMeshVertices(
+    GFX_3D_RENDERER *renderer, int first_vertex,
+    const GFX_3D_MESH_VERTEX *vertices, int vertex_count);
+
+// Draws a range of the uploaded triangles. Back faces are culled, and the
+// triangles are clipped to the near and far planes and to the clip
+// rectangle.
+void GFX_3D_Renderer_DrawMesh(
+    GFX_3D_RENDERER *renderer, const GFX_3D_MESH_PARAMS *params,
+    int first_index, int index_count);
+
 void GFX_3D_Renderer_RenderPrimStrip(
     GFX_3D_RENDERER *renderer, const GFX_3D_VERTEX *vertices, int count);
 void GFX_3D_Renderer_RenderPrimFan(
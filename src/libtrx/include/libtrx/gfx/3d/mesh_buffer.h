@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../gl/buffer.h"
+#include "../gl/vertex_array.h"
+
+#include <stdint.h>
+
+// A vertex of static geometry. It stays in object space and is transformed,
+// projected and lit on the GPU.
+typedef struct {
+    float x, y, z;
+    float u, v; // raw 16-bit texture coordinates
+    float layer;
+    float shade;
+} GFX_3D_MESH_VERTEX;
+
+// Static geometry that is uploaded once and then drawn in index ranges.
+typedef struct {
+    bool is_loaded;
+    GFX_GL_BUFFER vertex_buffer;
+    GFX_GL_BUFFER index_buffer;
+    GFX_GL_VERTEX_ARRAY vtc_format;
+    int32_t index_count;
+} GFX_3D_MESH_BUFFER;
+
+void GFX_3D_MeshBuffer_Init(GFX_3D_MESH_BUFFER *mesh_buffer);
+void GFX_3D_MeshBuffer_Close(GFX_3D_MESH_BUFFER *mesh_buffer);
+
+void GFX_3D_MeshBuffer_Upload(
+    GFX_3D_MESH_BUFFER *mesh_buffer, const GFX_3D_MESH_VERTEX *vertices,
+    int32_t vertex_count, const uint32_t *indices, int32_t index_count);
+void GFX_3D_MeshBuffer_Release(GFX_3D_MESH_BUFFER *mesh_buffer);
+void GFX_3D_MeshBuffer_UpdateVertices(
+    GFX_3D_MESH_BUFFER *mesh_buffer, int32_t first_vertex,
+    const GFX_3D_MESH_VERTEX *vertices, int32_t vertex_count);
+
+// Draws triangles from the given range of the uploaded indices.
+void GFX_3D_MeshBuffer_Draw(
+    GFX_3D_MESH_BUFFER *mesh_buffer, int32_t first_index, int32_t index_count);
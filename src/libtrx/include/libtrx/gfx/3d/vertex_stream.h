@@ -3,6 +3,13 @@
 #include "../gl/buffer.h"
 #include "../gl/vertex_array.h"
 
+#include <stdint.h>
+
+// The stream buffers are split into this many segments, so that the GPU can
+// still draw from the older ones while new data is being written. There must
+// be at least two, so that the segment being filled is never waited on.
+#define GFX_3D_VERTEX_STREAM_SEGMENTS 3
+
 typedef enum {
     GFX_3D_PRIM_LINE = 0,
     GFX_3D_PRIM_TRI = 1,
@@ -12,18 +19,35 @@ typedef struct {
     float x, y, z;
     float s, t, w;
     float r, g, b, a;
+    float layer; // only used with texture arrays
 } GFX_3D_VERTEX;
 
 typedef struct {
-    GFX_3D_PRIM_TYPE prim_type;
-    size_t buffer_size;
     GFX_GL_BUFFER buffer;
+    bool is_persistent;
+    size_t size;
+    size_t offset;
+    size_t segment_size;
+    void *map;
+    GLsync fences[GFX_3D_VERTEX_STREAM_SEGMENTS];
+} GFX_3D_STREAM_BUFFER;
+
+typedef struct {
+    GFX_3D_PRIM_TYPE prim_type;
+    bool has_base_vertex;
+    GFX_3D_STREAM_BUFFER vertex_buffer;
+    GFX_3D_STREAM_BUFFER index_buffer;
     GFX_GL_VERTEX_ARRAY vtc_format;
     struct {
         GFX_3D_VERTEX *data;
         size_t count;
         size_t capacity;
     } pending_vertices;
+    struct {
+        uint16_t *data;
+        size_t count;
+        size_t capacity;
+    } pending_indices;
     size_t rendered_count;
     size_t transferred;
 } GFX_3D_VERTEX_STREAM;
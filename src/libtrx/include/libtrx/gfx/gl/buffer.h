@@ -16,6 +16,10 @@ void GFX_GL_Buffer_Data(
     GFX_GL_BUFFER *buf, GLsizei size, const void *data, GLenum usage);
 void GFX_GL_Buffer_SubData(
     GFX_GL_BUFFER *buf, GLsizei offset, GLsizei size, const void *data);
+void GFX_GL_Buffer_Storage(
+    GFX_GL_BUFFER *buf, GLsizeiptr size, const void *data, GLbitfield flags);
 void *GFX_GL_Buffer_Map(GFX_GL_BUFFER *buf, GLenum access);
+void *GFX_GL_Buffer_MapRange(
+    GFX_GL_BUFFER *buf, GLintptr offset, GLsizeiptr length, GLbitfield access);
 void GFX_GL_Buffer_Unmap(GFX_GL_BUFFER *buf);
 GLint GFX_GL_Buffer_Parameter(GFX_GL_BUFFER *buf, GLenum pname);
@@ -17,4 +17,7 @@ void GFX_GL_Texture_Bind(GFX_GL_TEXTURE *texture);
 void GFX_GL_Texture_Load(
     GFX_GL_TEXTURE *texture, const void *data, int width, int height,
     GLint internal_format, GLint format);
+void GFX_GL_Texture_LoadArray(
+    GFX_GL_TEXTURE *texture, const void *data, int width, int height,
+    int layer_count, GLint internal_format, GLint format);
 void GFX_GL_Texture_LoadFromBackBuffer(GFX_GL_TEXTURE *texture);
@@ -4,6 +4,8 @@
 #define JSON_INVALID_STRING nullptr
 #define JSON_INVALID_NUMBER 0x7FFFFFFF
 
+#include "memory.h"
+
 #include <inttypes.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -46,6 +48,10 @@ typedef struct {
     size_t ref_count;
 } JSON_NUMBER;
 
+// Lookup tables that are built on demand for large arrays and objects.
+typedef struct JSON_ARRAY_INDEX JSON_ARRAY_INDEX;
+typedef struct JSON_OBJECT_INDEX JSON_OBJECT_INDEX;
+
 typedef struct JSON_OBJECT_ELEMENT {
     JSON_STRING *name;
     JSON_VALUE *value;
@@ -55,6 +61,8 @@ typedef struct JSON_OBJECT_ELEMENT {
 
 typedef struct {
     JSON_OBJECT_ELEMENT *start;
+    JSON_OBJECT_ELEMENT *end;
+    JSON_OBJECT_INDEX *index;
     size_t length;
     size_t ref_count;
 } JSON_OBJECT;
@@ -67,6 +75,8 @@ typedef struct JSON_ARRAY_ELEMENT {
 
 typedef struct {
     JSON_ARRAY_ELEMENT *start;
+    JSON_ARRAY_ELEMENT *end;
+    JSON_ARRAY_INDEX *index;
     size_t length;
     size_t ref_count;
 } JSON_ARRAY;
@@ -78,6 +88,14 @@ typedef struct {
     size_t row_no;
 } JSON_VALUE_EX;
 
+// Routes the allocations of new values, arrays, objects and parsed documents
+// to an arena until JSON_ArenaEnd is called. The memory is then owned by the
+// arena and released all at once when it is reset; JSON_ValueFree should
+// still be called on the root beforehand to release any lookup tables. The
+// arena is global, so trees must only be built from one thread at a time.
+void JSON_ArenaBegin(MEMORY_ARENA_ALLOCATOR *arena);
+void JSON_ArenaEnd(void);
+
 // values
 JSON_VALUE *JSON_ValueFromBool(int b);
 JSON_VALUE *JSON_ValueFromInt(int number);
@@ -247,7 +265,8 @@ typedef enum {
 } JSON_PARSE_FLAGS;
 
 /* Parse a JSON text file, returning a pointer to the root of the JSON
- * structure. JSON_Parse performs 1 call to malloc for the entire encoding.
+ * structure. JSON_Parse performs 1 call to malloc for the entire encoding, or
+ * takes it from the active arena (see JSON_ArenaBegin).
  * Returns 0 if an error occurred (malformed JSON input, or malloc failed). */
 JSON_VALUE *JSON_Parse(const void *src, size_t src_size);
 
@@ -58,7 +58,7 @@ char *Memory_DupStr(const char *string);
 
 // Allocate n bytes using the arena allocator. If there's insufficient memory,
 // grow the buffer using internal growth function. The allocated memory is
-// filled with zeros.
+// filled with zeros and suitably aligned for any type.
 void *Memory_ArenaAlloc(MEMORY_ARENA_ALLOCATOR *allocator, size_t size);
 
 // Resets the buffer used by the arena allocator, but does not free the memory.
@@ -67,5 +67,5 @@ void *Memory_ArenaAlloc(MEMORY_ARENA_ALLOCATOR *allocator, size_t size);
 void Memory_ArenaReset(MEMORY_ARENA_ALLOCATOR *allocator);
 
 // Frees the entire buffer owned by the arena allocator. allocator must not be
-// nullptr.
+// nullptr. The allocator can be used again afterwards.
 void Memory_ArenaFree(MEMORY_ARENA_ALLOCATOR *allocator);
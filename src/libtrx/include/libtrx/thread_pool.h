@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+// A fixed set of worker threads for splitting work into independent tasks.
+// The calling thread takes part in the work and the pool must only be driven
+// from one thread at a time.
+typedef struct THREAD_POOL THREAD_POOL;
+
+typedef void (*THREAD_POOL_TASK)(void *arg, int32_t task_idx);
+
+// Creates a pool with the given number of worker threads, in addition to the
+// calling thread. A negative number uses one worker per additional CPU core.
+THREAD_POOL *ThreadPool_Create(const char *name, int32_t worker_count);
+void ThreadPool_Free(THREAD_POOL *pool);
+
+// Number of threads that take part in ThreadPool_Run, including the caller.
+int32_t ThreadPool_GetThreadCount(const THREAD_POOL *pool);
+
+// Runs task(arg, i) for every i in [0, task_count) and returns when all tasks
+// are finished. Tasks are picked up in order, but may finish in any order.
+void ThreadPool_Run(
+    THREAD_POOL *pool, int32_t task_count, THREAD_POOL_TASK task, void *arg);
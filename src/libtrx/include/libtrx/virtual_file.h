@@ -7,8 +7,11 @@ typedef struct {
     char *content;
     size_t size;
     char *cur_ptr;
+    bool is_mapped;
 } VFILE;
 
+// Maps the file into memory where the platform allows it, and reads it into
+// a buffer otherwise. Mapped files are copy-on-write.
 VFILE *VFile_CreateFromPath(const char *path);
 VFILE *VFile_CreateFromBuffer(const char *data, size_t size);
 void VFile_Close(VFILE *file);
@@ -25,6 +28,11 @@ uint8_t VFile_ReadU8(VFILE *file);
 uint16_t VFile_ReadU16(VFILE *file);
 uint32_t VFile_ReadU32(VFILE *file);
 
+// Returns the next size bytes without copying them and skips past them. The
+// data is valid until the file is closed and is not necessarily aligned.
+const void *VFile_ReadView(VFILE *file, size_t size);
+void VFile_ReadS16Array(VFILE *file, int16_t *target, size_t count);
+
 bool VFile_TrySkip(VFILE *file, int32_t offset);
 bool VFile_TryRead(VFILE *file, void *target, size_t size);
 bool VFile_TryReadS8(VFILE *file, int8_t *dst);
@@ -1,6 +1,7 @@
 #include "bson.h"
 
 #include "debug.h"
+#include "json/priv.h"
 #include "log.h"
 #include "memory.h"
 
@@ -469,6 +470,8 @@ static void M_HandleArray(M_STATE *state, JSON_ARRAY *array)
     if (!count) {
         array->start = nullptr;
     }
+    array->end = previous;
+    array->index = nullptr;
     array->ref_count = 1;
     array->length = count;
     ASSERT(state->offset + sizeof(char) <= state->size);
@@ -547,6 +550,8 @@ static void M_HandleObject(M_STATE *state, JSON_OBJECT *object)
     if (!count) {
         object->start = nullptr;
     }
+    object->end = previous;
+    object->index = nullptr;
     object->ref_count = 1;
     object->length = count;
     ASSERT(state->offset + sizeof(char) <= state->size);
@@ -648,14 +653,14 @@ JSON_VALUE *BSON_ParseEx(
 
     total_size = state.dom_size + state.data_size;
 
-    allocation = Memory_Alloc(total_size);
+    allocation = JSON_AllocNode(total_size);
     state.offset = 0;
     state.dom = (char *)allocation;
     state.data = state.dom + state.dom_size;
 
     // assume the root element to be an object
     value = (JSON_VALUE *)state.dom;
-    value->ref_count = 0;
+    value->ref_count = JSON_GetNodeRefCount();
     state.dom += sizeof(JSON_VALUE);
     M_HandleObjectValue(&state, value);
 
@@ -10,6 +10,16 @@
 #include <stdlib.h>
 #include <string.h>
 
+#define M_STREAM_BUFFER_SIZE (16 * 1024)
+
+typedef struct {
+    BSON_WRITE_FUNC func;
+    void *user_data;
+    bool is_ok;
+    size_t size;
+    char buffer[M_STREAM_BUFFER_SIZE];
+} M_STREAM;
+
 static bool M_GetMarkerSize(size_t *size, const char *key);
 static bool M_GetNullWrappedSize(size_t *size, const char *key);
 static bool M_GetBoolWrappedSize(size_t *size, const char *key);
@@ -56,6 +66,15 @@ static char *M_WriteValue(char *data, const JSON_VALUE *value);
 static char *M_WriteValueWrapped(
     char *data, const char *key, const JSON_VALUE *value);
 
+static void M_StreamFlush(M_STREAM *stream);
+static char *M_StreamReserve(M_STREAM *stream, size_t size);
+static void M_StreamWriteMarker(
+    M_STREAM *stream, const char *key, uint8_t marker);
+static void M_StreamWriteArray(M_STREAM *stream, const JSON_ARRAY *array);
+static void M_StreamWriteObject(M_STREAM *stream, const JSON_OBJECT *object);
+static void M_StreamWriteValueWrapped(
+    M_STREAM *stream, const char *key, const JSON_VALUE *value);
+
 static bool M_GetMarkerSize(size_t *size, const char *key)
 {
     ASSERT(size != nullptr);
@@ -509,6 +528,106 @@ static char *M_WriteValueWrapped(
     }
 }
 
+static void M_StreamFlush(M_STREAM *const stream)
+{
+    if (stream->size > 0 && stream->is_ok) {
+        stream->is_ok =
+            stream->func(stream->buffer, stream->size, stream->user_data);
+    }
+    stream->size = 0;
+}
+
+static char *M_StreamReserve(M_STREAM *const stream, const size_t size)
+{
+    ASSERT(size <= M_STREAM_BUFFER_SIZE);
+    if (stream->size + size > M_STREAM_BUFFER_SIZE) {
+        M_StreamFlush(stream);
+    }
+    char *const data = stream->buffer + stream->size;
+    stream->size += size;
+    return data;
+}
+
+static void M_StreamWriteMarker(
+    M_STREAM *const stream, const char *const key, const uint8_t marker)
+{
+    size_t size = 0;
+    M_GetMarkerSize(&size, key);
+    M_WriteMarker(M_StreamReserve(stream, size), key, marker);
+}
+
+static void M_StreamWriteArray(
+    M_STREAM *const stream, const JSON_ARRAY *const array)
+{
+    size_t size = 0;
+    M_GetArraySize(&size, array);
+    M_WriteInt32(M_StreamReserve(stream, sizeof(int32_t)), size);
+
+    char key[12];
+    int idx = 0;
+    for (JSON_ARRAY_ELEMENT *element = array->start; element != nullptr;
+         element = element->next) {
+        sprintf(key, "%d", idx);
+        idx++;
+        M_StreamWriteValueWrapped(stream, key, element->value);
+    }
+    *M_StreamReserve(stream, 1) = '\0';
+}
+
+static void M_StreamWriteObject(
+    M_STREAM *const stream, const JSON_OBJECT *const object)
+{
+    size_t size = 0;
+    M_GetObjectSize(&size, object);
+    M_WriteInt32(M_StreamReserve(stream, sizeof(int32_t)), size);
+
+    for (JSON_OBJECT_ELEMENT *element = object->start; element != nullptr;
+         element = element->next) {
+        M_StreamWriteValueWrapped(
+            stream, element->name->string, element->value);
+    }
+    *M_StreamReserve(stream, 1) = '\0';
+}
+
+static void M_StreamWriteValueWrapped(
+    M_STREAM *const stream, const char *const key,
+    const JSON_VALUE *const value)
+{
+    // Containers are written piece by piece, everything else goes through
+    // the regular writer.
+    switch (value->type) {
+    case JSON_TYPE_ARRAY:
+        M_StreamWriteMarker(stream, key, '\x04');
+        M_StreamWriteArray(stream, (JSON_ARRAY *)value->payload);
+        return;
+    case JSON_TYPE_OBJECT:
+        M_StreamWriteMarker(stream, key, '\x03');
+        M_StreamWriteObject(stream, (JSON_OBJECT *)value->payload);
+        return;
+    default:
+        break;
+    }
+
+    size_t size = 0;
+    if (!M_GetValueWrappedSize(&size, key, value)) {
+        stream->is_ok = false;
+        return;
+    }
+
+    if (size <= M_STREAM_BUFFER_SIZE) {
+        M_WriteValueWrapped(M_StreamReserve(stream, size), key, value);
+    } else {
+        // Only very long strings end up here.
+        char *data = Memory_Alloc(size);
+        M_WriteValueWrapped(data, key, value);
+        M_StreamFlush(stream);
+        if (stream->is_ok) {
+            stream->is_ok = stream->func(data, size, stream->user_data);
+        }
+        Memory_FreePointer(&data);
+    }
+}
+
 void *BSON_Write(const JSON_VALUE *value, size_t *out_size)
 {
     ASSERT(value != nullptr);
@@ -532,3 +651,34 @@ void *BSON_Write(const JSON_VALUE *value, size_t *out_size)
 
     return data;
 }
+
+bool BSON_WriteStream(
+    const JSON_VALUE *const value, const BSON_WRITE_FUNC func,
+    void *const user_data)
+{
+    ASSERT(value != nullptr);
+    ASSERT(func != nullptr);
+
+    M_STREAM *stream = Memory_Alloc(sizeof(M_STREAM));
+    stream->func = func;
+    stream->user_data = user_data;
+    stream->is_ok = true;
+
+    switch (value->type) {
+    case JSON_TYPE_ARRAY:
+        M_StreamWriteArray(stream, (JSON_ARRAY *)value->payload);
+        break;
+    case JSON_TYPE_OBJECT:
+        M_StreamWriteObject(stream, (JSON_OBJECT *)value->payload);
+        break;
+    default:
+        LOG_ERROR("Bad BSON root element: %d", value->type);
+        stream->is_ok = false;
+        break;
+    }
+
+    M_StreamFlush(stream);
+    const bool result = stream->is_ok;
+    Memory_FreePointer(&stream);
+    return result;
+}
@@ -1,5 +1,6 @@
 #include "json.h"
 
+#include "json/priv.h"
 #include "memory.h"
 
 #include <inttypes.h>
@@ -7,6 +8,22 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Objects get a hash index only once they have this many keys; smaller ones
+// are faster to scan.
+#define M_OBJECT_INDEX_THRESHOLD 8
+
+static MEMORY_ARENA_ALLOCATOR *m_Arena = nullptr;
+
+struct JSON_ARRAY_INDEX {
+    size_t capacity;
+    JSON_ARRAY_ELEMENT **elements;
+};
+
+struct JSON_OBJECT_INDEX {
+    size_t capacity;
+    JSON_OBJECT_ELEMENT **slots;
+};
+
 static JSON_NUMBER *M_NumberNewInt(int number);
 static JSON_NUMBER *M_NumberNewInt64(int64_t number);
 static JSON_NUMBER *M_NumberNewDouble(double number);
@@ -24,12 +41,27 @@ static JSON_ARRAY *M_ValueAsArray(JSON_VALUE *const value);
 static void M_ArrayElementFree(JSON_ARRAY_ELEMENT *element);
 static void M_ObjectElementFree(JSON_OBJECT_ELEMENT *element);
 
+static JSON_ARRAY_ELEMENT *M_ArrayGetEnd(JSON_ARRAY *arr);
+static void M_ArrayIndexFree(JSON_ARRAY *arr);
+static void M_ArrayIndexAppend(JSON_ARRAY_INDEX *index, size_t idx);
+static JSON_ARRAY_INDEX *M_ArrayIndexBuild(JSON_ARRAY *arr);
+
+static uint32_t M_HashKey(const char *key);
+static JSON_OBJECT_ELEMENT *M_ObjectGetEnd(JSON_OBJECT *obj);
+static void M_ObjectIndexFree(JSON_OBJECT *obj);
+static void M_ObjectIndexInsert(
+    JSON_OBJECT_INDEX *index, JSON_OBJECT_ELEMENT *elem);
+static JSON_OBJECT_INDEX *M_ObjectIndexBuild(JSON_OBJECT *obj);
+static JSON_OBJECT_ELEMENT *M_ObjectFindElement(
+    JSON_OBJECT *obj, const char *key);
+
 static JSON_NUMBER *M_NumberNewInt(const int number)
 {
     const size_t size = snprintf(nullptr, 0, "%d", number) + 1;
-    char *const buf = Memory_Alloc(size);
+    char *const buf = JSON_AllocNode(size);
     sprintf(buf, "%d", number);
-    JSON_NUMBER *const elem = Memory_Alloc(sizeof(JSON_NUMBER));
+    JSON_NUMBER *const elem = JSON_AllocNode(sizeof(JSON_NUMBER));
+    elem->ref_count = JSON_GetNodeRefCount();
     elem->number = buf;
     elem->number_size = strlen(buf);
     return elem;
@@ -38,9 +70,10 @@ static JSON_NUMBER *M_NumberNewInt(const int number)
 static JSON_NUMBER *M_NumberNewInt64(const int64_t number)
 {
     const size_t size = snprintf(nullptr, 0, "%" PRId64, number) + 1;
-    char *const buf = Memory_Alloc(size);
+    char *const buf = JSON_AllocNode(size);
     sprintf(buf, "%" PRId64, number);
-    JSON_NUMBER *const elem = Memory_Alloc(sizeof(JSON_NUMBER));
+    JSON_NUMBER *const elem = JSON_AllocNode(sizeof(JSON_NUMBER));
+    elem->ref_count = JSON_GetNodeRefCount();
     elem->number = buf;
     elem->number_size = strlen(buf);
     return elem;
@@ -49,7 +82,7 @@ static JSON_NUMBER *M_NumberNewInt64(const int64_t number)
 static JSON_NUMBER *M_NumberNewDouble(const double number)
 {
     const size_t size = snprintf(nullptr, 0, "%f", number) + 3;
-    char *const buf = Memory_Alloc(size);
+    char *const buf = JSON_AllocNode(size);
     sprintf(buf, "%f", number);
 
     // Remove trailing zeros, keeping at least one digit after the decimal point
@@ -71,7 +104,8 @@ static JSON_NUMBER *M_NumberNewDouble(const double number)
         }
     }
 
-    JSON_NUMBER *const elem = Memory_Alloc(sizeof(JSON_NUMBER));
+    JSON_NUMBER *const elem = JSON_AllocNode(sizeof(JSON_NUMBER));
+    elem->ref_count = JSON_GetNodeRefCount();
     elem->number = buf;
     elem->number_size = strlen(buf);
     return elem;
@@ -87,8 +121,10 @@ static void M_NumberFree(JSON_NUMBER *const num)
 
 static JSON_STRING *M_StringNew(const char *const string)
 {
-    JSON_STRING *const str = Memory_Alloc(sizeof(JSON_STRING));
-    str->string = Memory_DupStr(string);
+    JSON_STRING *const str = JSON_AllocNode(sizeof(JSON_STRING));
+    str->ref_count = JSON_GetNodeRefCount();
+    str->string = JSON_AllocNode(strlen(string) + 1);
+    strcpy(str->string, string);
     str->string_size = strlen(string);
     return str;
 }
@@ -103,7 +139,8 @@ static void M_StringFree(JSON_STRING *const str)
 
 static JSON_VALUE *M_ValueFromNumber(JSON_NUMBER *const num)
 {
-    JSON_VALUE *const value = Memory_Alloc(sizeof(JSON_VALUE));
+    JSON_VALUE *const value = JSON_AllocNode(sizeof(JSON_VALUE));
+    value->ref_count = JSON_GetNodeRefCount();
     value->type = JSON_TYPE_NUMBER;
     value->payload = num;
     return value;
@@ -155,9 +192,188 @@ static void M_ObjectElementFree(JSON_OBJECT_ELEMENT *element)
     }
 }
 
+static JSON_ARRAY_ELEMENT *M_ArrayGetEnd(JSON_ARRAY *const arr)
+{
+    // Arrays built outside of this module may not have the tail set.
+    if (arr->end == nullptr && arr->start != nullptr) {
+        JSON_ARRAY_ELEMENT *elem = arr->start;
+        while (elem->next != nullptr) {
+            elem = elem->next;
+        }
+        arr->end = elem;
+    }
+    return arr->end;
+}
+
+static void M_ArrayIndexFree(JSON_ARRAY *const arr)
+{
+    if (arr->index == nullptr) {
+        return;
+    }
+    Memory_Free(arr->index->elements);
+    Memory_FreePointer(&arr->index);
+}
+
+static void M_ArrayIndexAppend(
+    JSON_ARRAY_INDEX *const index, const size_t idx)
+{
+    if (idx < index->capacity) {
+        return;
+    }
+    const size_t old_capacity = index->capacity;
+    while (index->capacity <= idx) {
+        index->capacity *= 2;
+    }
+    index->elements = Memory_Realloc(
+        index->elements, sizeof(JSON_ARRAY_ELEMENT *) * index->capacity);
+    memset(
+        &index->elements[old_capacity], 0,
+        sizeof(JSON_ARRAY_ELEMENT *) * (index->capacity - old_capacity));
+}
+
+static JSON_ARRAY_INDEX *M_ArrayIndexBuild(JSON_ARRAY *const arr)
+{
+    JSON_ARRAY_INDEX *const index = Memory_Alloc(sizeof(JSON_ARRAY_INDEX));
+    index->capacity = 16;
+    while (index->capacity < arr->length) {
+        index->capacity *= 2;
+    }
+    index->elements =
+        Memory_Alloc(sizeof(JSON_ARRAY_ELEMENT *) * index->capacity);
+
+    size_t i = 0;
+    JSON_ARRAY_ELEMENT *elem = arr->start;
+    while (elem != nullptr && i < arr->length) {
+        index->elements[i++] = elem;
+        elem = elem->next;
+    }
+    arr->index = index;
+    return index;
+}
+
+static uint32_t M_HashKey(const char *key)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261U;
+    while (*key != '\0') {
+        hash ^= (uint8_t)*key++;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+static JSON_OBJECT_ELEMENT *M_ObjectGetEnd(JSON_OBJECT *const obj)
+{
+    if (obj->end == nullptr && obj->start != nullptr) {
+        JSON_OBJECT_ELEMENT *elem = obj->start;
+        while (elem->next != nullptr) {
+            elem = elem->next;
+        }
+        obj->end = elem;
+    }
+    return obj->end;
+}
+
+static void M_ObjectIndexFree(JSON_OBJECT *const obj)
+{
+    if (obj->index == nullptr) {
+        return;
+    }
+    Memory_Free(obj->index->slots);
+    Memory_FreePointer(&obj->index);
+}
+
+static void M_ObjectIndexInsert(
+    JSON_OBJECT_INDEX *const index, JSON_OBJECT_ELEMENT *const elem)
+{
+    const size_t mask = index->capacity - 1;
+    size_t slot = M_HashKey(elem->name->string) & mask;
+    while (index->slots[slot] != nullptr) {
+        // Keep the first occurrence of duplicate keys, like a linear scan.
+        if (!strcmp(index->slots[slot]->name->string, elem->name->string)) {
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+    index->slots[slot] = elem;
+}
+
+static JSON_OBJECT_INDEX *M_ObjectIndexBuild(JSON_OBJECT *const obj)
+{
+    JSON_OBJECT_INDEX *const index = Memory_Alloc(sizeof(JSON_OBJECT_INDEX));
+    index->capacity = 16;
+    while (index->capacity < obj->length * 2) {
+        index->capacity *= 2;
+    }
+    index->slots =
+        Memory_Alloc(sizeof(JSON_OBJECT_ELEMENT *) * index->capacity);
+
+    JSON_OBJECT_ELEMENT *elem = obj->start;
+    while (elem != nullptr) {
+        M_ObjectIndexInsert(index, elem);
+        elem = elem->next;
+    }
+    obj->index = index;
+    return index;
+}
+
+static JSON_OBJECT_ELEMENT *M_ObjectFindElement(
+    JSON_OBJECT *const obj, const char *const key)
+{
+    if (obj->index == nullptr && obj->length >= M_OBJECT_INDEX_THRESHOLD) {
+        M_ObjectIndexBuild(obj);
+    }
+
+    if (obj->index != nullptr) {
+        const JSON_OBJECT_INDEX *const index = obj->index;
+        const size_t mask = index->capacity - 1;
+        size_t slot = M_HashKey(key) & mask;
+        while (index->slots[slot] != nullptr) {
+            if (!strcmp(index->slots[slot]->name->string, key)) {
+                return index->slots[slot];
+            }
+            slot = (slot + 1) & mask;
+        }
+        return nullptr;
+    }
+
+    JSON_OBJECT_ELEMENT *elem = obj->start;
+    while (elem != nullptr) {
+        if (!strcmp(elem->name->string, key)) {
+            return elem;
+        }
+        elem = elem->next;
+    }
+    return nullptr;
+}
+
+void *JSON_AllocNode(const size_t size)
+{
+    if (m_Arena != nullptr) {
+        return Memory_ArenaAlloc(m_Arena, size);
+    }
+    return Memory_Alloc(size);
+}
+
+size_t JSON_GetNodeRefCount(void)
+{
+    return m_Arena != nullptr ? 1 : 0;
+}
+
+void JSON_ArenaBegin(MEMORY_ARENA_ALLOCATOR *const arena)
+{
+    m_Arena = arena;
+}
+
+void JSON_ArenaEnd(void)
+{
+    m_Arena = nullptr;
+}
+
 JSON_VALUE *JSON_ValueFromBool(const int b)
 {
-    JSON_VALUE *const value = Memory_Alloc(sizeof(JSON_VALUE));
+    JSON_VALUE *const value = JSON_AllocNode(sizeof(JSON_VALUE));
+    value->ref_count = JSON_GetNodeRefCount();
     value->type = b ? JSON_TYPE_TRUE : JSON_TYPE_FALSE;
     value->payload = nullptr;
     return value;
@@ -180,7 +396,8 @@ JSON_VALUE *JSON_ValueFromDouble(const double number)
 
 JSON_VALUE *JSON_ValueFromString(const char *const string)
 {
-    JSON_VALUE *const value = Memory_Alloc(sizeof(JSON_VALUE));
+    JSON_VALUE *const value = JSON_AllocNode(sizeof(JSON_VALUE));
+    value->ref_count = JSON_GetNodeRefCount();
     value->type = JSON_TYPE_STRING;
     value->payload = M_StringNew(string);
     return value;
@@ -188,7 +405,8 @@ JSON_VALUE *JSON_ValueFromString(const char *const string)
 
 JSON_VALUE *JSON_ValueFromArray(JSON_ARRAY *const arr)
 {
-    JSON_VALUE *const value = Memory_Alloc(sizeof(JSON_VALUE));
+    JSON_VALUE *const value = JSON_AllocNode(sizeof(JSON_VALUE));
+    value->ref_count = JSON_GetNodeRefCount();
     value->type = JSON_TYPE_ARRAY;
     value->payload = arr;
     return value;
@@ -196,7 +414,8 @@ JSON_VALUE *JSON_ValueFromArray(JSON_ARRAY *const arr)
 
 JSON_VALUE *JSON_ValueFromObject(JSON_OBJECT *const obj)
 {
-    JSON_VALUE *const value = Memory_Alloc(sizeof(JSON_VALUE));
+    JSON_VALUE *const value = JSON_AllocNode(sizeof(JSON_VALUE));
+    value->ref_count = JSON_GetNodeRefCount();
     value->type = JSON_TYPE_OBJECT;
     value->payload = obj;
     return value;
@@ -204,7 +423,9 @@ JSON_VALUE *JSON_ValueFromObject(JSON_OBJECT *const obj)
 
 void JSON_ValueFree(JSON_VALUE *const value)
 {
-    if (value == nullptr || value->ref_count != 0) {
+    // Values owned by a parsed document are walked too, so that any lookup
+    // tables built for their arrays and objects are released.
+    if (value == nullptr) {
         return;
     }
 
@@ -227,7 +448,9 @@ void JSON_ValueFree(JSON_VALUE *const value)
         break;
     }
 
-    Memory_Free(value);
+    if (value->ref_count == 0) {
+        Memory_Free(value);
+    }
 }
 
 bool JSON_ValueIsNull(const JSON_VALUE *const value)
@@ -292,7 +515,8 @@ JSON_OBJECT *JSON_ValueAsObject(JSON_VALUE *const value)
 
 JSON_ARRAY *JSON_ArrayNew(void)
 {
-    JSON_ARRAY *const arr = Memory_Alloc(sizeof(JSON_ARRAY));
+    JSON_ARRAY *const arr = JSON_AllocNode(sizeof(JSON_ARRAY));
+    arr->ref_count = JSON_GetNodeRefCount();
     arr->start = nullptr;
     arr->length = 0;
     return arr;
@@ -307,6 +531,7 @@ void JSON_ArrayFree(JSON_ARRAY *const arr)
         M_ArrayElementFree(elem);
         elem = next;
     }
+    M_ArrayIndexFree(arr);
     if (arr->ref_count == 0) {
         Memory_Free(arr);
     }
@@ -314,18 +539,21 @@ void JSON_ArrayFree(JSON_ARRAY *const arr)
 
 void JSON_ArrayAppend(JSON_ARRAY *const arr, JSON_VALUE *const value)
 {
-    JSON_ARRAY_ELEMENT *elem = Memory_Alloc(sizeof(JSON_ARRAY_ELEMENT));
+    JSON_ARRAY_ELEMENT *elem = JSON_AllocNode(sizeof(JSON_ARRAY_ELEMENT));
+    elem->ref_count = JSON_GetNodeRefCount();
     elem->value = value;
     elem->next = nullptr;
-    if (arr->start) {
-        JSON_ARRAY_ELEMENT *target = arr->start;
-        while (target->next) {
-            target = target->next;
-        }
-        target->next = elem;
+    JSON_ARRAY_ELEMENT *const end = M_ArrayGetEnd(arr);
+    if (end != nullptr) {
+        end->next = elem;
     } else {
         arr->start = elem;
     }
+    arr->end = elem;
+    if (arr->index != nullptr) {
+        M_ArrayIndexAppend(arr->index, arr->length);
+        arr->index->elements[arr->length] = elem;
+    }
     arr->length++;
 }
 
@@ -364,11 +592,10 @@ JSON_VALUE *JSON_ArrayGetValue(JSON_ARRAY *const arr, const size_t idx)
     if (arr == nullptr || idx >= arr->length) {
         return nullptr;
     }
-    JSON_ARRAY_ELEMENT *elem = arr->start;
-    for (size_t i = 0; i < idx; i++) {
-        elem = elem->next;
+    if (arr->index == nullptr) {
+        M_ArrayIndexBuild(arr);
     }
-    return elem->value;
+    return arr->index->elements[idx]->value;
 }
 
 int JSON_ArrayGetBool(
@@ -412,7 +639,8 @@ JSON_OBJECT *JSON_ArrayGetObject(JSON_ARRAY *arr, const size_t idx)
 
 JSON_OBJECT *JSON_ObjectNew(void)
 {
-    JSON_OBJECT *obj = Memory_Alloc(sizeof(JSON_OBJECT));
+    JSON_OBJECT *obj = JSON_AllocNode(sizeof(JSON_OBJECT));
+    obj->ref_count = JSON_GetNodeRefCount();
     obj->start = nullptr;
     obj->length = 0;
     return obj;
@@ -428,6 +656,7 @@ void JSON_ObjectFree(JSON_OBJECT *obj)
         M_ObjectElementFree(elem);
         elem = next;
     }
+    M_ObjectIndexFree(obj);
     if (obj->ref_count == 0) {
         Memory_Free(obj);
     }
@@ -436,20 +665,26 @@ void JSON_ObjectFree(JSON_OBJECT *obj)
 void JSON_ObjectAppend(
     JSON_OBJECT *const obj, const char *const key, JSON_VALUE *const value)
 {
-    JSON_OBJECT_ELEMENT *elem = Memory_Alloc(sizeof(JSON_OBJECT_ELEMENT));
+    JSON_OBJECT_ELEMENT *elem = JSON_AllocNode(sizeof(JSON_OBJECT_ELEMENT));
+    elem->ref_count = JSON_GetNodeRefCount();
     elem->name = M_StringNew(key);
     elem->value = value;
     elem->next = nullptr;
-    if (obj->start) {
-        JSON_OBJECT_ELEMENT *target = obj->start;
-        while (target->next) {
-            target = target->next;
-        }
-        target->next = elem;
+    JSON_OBJECT_ELEMENT *const end = M_ObjectGetEnd(obj);
+    if (end != nullptr) {
+        end->next = elem;
     } else {
         obj->start = elem;
     }
+    obj->end = elem;
     obj->length++;
+    if (obj->index != nullptr) {
+        if (obj->length * 2 > obj->index->capacity) {
+            M_ObjectIndexFree(obj);
+        } else {
+            M_ObjectIndexInsert(obj->index, elem);
+        }
+    }
 }
 
 void JSON_ObjectAppendBool(JSON_OBJECT *obj, const char *key, int b)
@@ -491,16 +726,7 @@ void JSON_ObjectAppendObject(
 
 bool JSON_ObjectContainsKey(JSON_OBJECT *const obj, const char *const key)
 {
-    JSON_OBJECT_ELEMENT *elem = obj->start;
-    while (elem != nullptr) {
-        if (!strcmp(elem->name->string, key)) {
-            return true;
-        }
-
-        elem = elem->next;
-    }
-
-    return false;
+    return M_ObjectFindElement(obj, key) != nullptr;
 }
 
 void JSON_ObjectEvictKey(JSON_OBJECT *const obj, const char *const key)
@@ -517,6 +743,12 @@ void JSON_ObjectEvictKey(JSON_OBJECT *const obj, const char *const key)
             } else {
                 prev->next = elem->next;
             }
+            if (obj->end == elem) {
+                obj->end = prev;
+            }
+            obj->length--;
+            // Removal is rare enough that the index is simply rebuilt.
+            M_ObjectIndexFree(obj);
             M_ObjectElementFree(elem);
             return;
         }
@@ -540,14 +772,8 @@ JSON_VALUE *JSON_ObjectGetValue(JSON_OBJECT *const obj, const char *const key)
     if (obj == nullptr) {
         return nullptr;
     }
-    JSON_OBJECT_ELEMENT *elem = obj->start;
-    while (elem) {
-        if (!strcmp(elem->name->string, key)) {
-            return elem->value;
-        }
-        elem = elem->next;
-    }
-    return nullptr;
+    const JSON_OBJECT_ELEMENT *const elem = M_ObjectFindElement(obj, key);
+    return elem != nullptr ? elem->value : nullptr;
 }
 
 int JSON_ObjectGetBool(
@@ -1,5 +1,6 @@
 #include "json.h"
 
+#include "json/priv.h"
 #include "memory.h"
 
 typedef struct {
@@ -1323,6 +1324,8 @@ static void M_HandleObject(
         object->start = nullptr;
     }
 
+    object->end = previous;
+    object->index = nullptr;
     object->ref_count = 1;
     object->length = elements;
 }
@@ -1413,6 +1416,8 @@ static void M_HandleArray(M_STATE *state, JSON_ARRAY *array)
         array->start = nullptr;
     }
 
+    array->end = previous;
+    array->index = nullptr;
     array->ref_count = 1;
     array->length = elements;
 }
@@ -1689,7 +1694,7 @@ JSON_VALUE *JSON_ParseEx(
     total_size = state.dom_size + state.data_size;
 
     if (nullptr == alloc_func_ptr) {
-        allocation = Memory_Alloc(total_size);
+        allocation = JSON_AllocNode(total_size);
     } else {
         allocation = alloc_func_ptr(user_data, total_size);
     }
@@ -1735,7 +1740,8 @@ JSON_VALUE *JSON_ParseEx(
         (int)(JSON_PARSE_FLAGS_ALLOW_GLOBAL_OBJECT & state.flags_bitset),
         value);
 
-    ((JSON_VALUE *)allocation)->ref_count = 0;
+    ((JSON_VALUE *)allocation)->ref_count =
+        nullptr == alloc_func_ptr ? JSON_GetNodeRefCount() : 0;
 
     return (JSON_VALUE *)allocation;
 }
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stddef.h>
+
+// Allocates zero-filled memory for a document, taking it from the active
+// arena if there is one.
+void *JSON_AllocNode(size_t size);
+
+// Nodes allocated from an arena are marked with a non-zero reference count,
+// so that freeing the tree doesn't release them one by one.
+size_t JSON_GetNodeRefCount(void);
@@ -3,16 +3,23 @@
 #include "debug.h"
 #include "utils.h"
 
+#include <stdalign.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#define M_ARENA_ALIGNMENT alignof(max_align_t)
+
 static MEMORY_ARENA_CHUNK *M_ArenaAllocChunk(
     MEMORY_ARENA_ALLOCATOR *allocator, size_t size);
+static size_t M_ArenaAlignOffset(const MEMORY_ARENA_CHUNK *chunk);
 
 static MEMORY_ARENA_CHUNK *M_ArenaAllocChunk(
     MEMORY_ARENA_ALLOCATOR *const allocator, const size_t size)
 {
-    const size_t new_chunk_size = MAX(allocator->default_chunk_size, size);
+    // Leave room for aligning the first allocation.
+    const size_t new_chunk_size =
+        MAX(allocator->default_chunk_size, size + M_ARENA_ALIGNMENT);
     MEMORY_ARENA_CHUNK *const new_chunk =
         Memory_Alloc(sizeof(MEMORY_ARENA_CHUNK) + new_chunk_size);
     new_chunk->memory = (char *)new_chunk + sizeof(MEMORY_ARENA_CHUNK);
@@ -22,6 +29,14 @@ static MEMORY_ARENA_CHUNK *M_ArenaAllocChunk(
     return new_chunk;
 }
 
+static size_t M_ArenaAlignOffset(const MEMORY_ARENA_CHUNK *const chunk)
+{
+    const uintptr_t address = (uintptr_t)chunk->memory + chunk->offset;
+    const uintptr_t padding =
+        (M_ARENA_ALIGNMENT - address % M_ARENA_ALIGNMENT) % M_ARENA_ALIGNMENT;
+    return chunk->offset + padding;
+}
+
 void *Memory_Alloc(const size_t size)
 {
     void *result = malloc(size);
@@ -79,7 +94,8 @@ void *Memory_ArenaAlloc(
 
     // Find first chunk that has enough space.
     MEMORY_ARENA_CHUNK *chunk = allocator->current_chunk;
-    while (chunk != nullptr && chunk->offset + size > chunk->size) {
+    while (chunk != nullptr
+        && M_ArenaAlignOffset(chunk) + size > chunk->size) {
         chunk = chunk->next;
     }
 
@@ -98,9 +114,12 @@ void *Memory_ArenaAlloc(
 
     ASSERT(chunk != nullptr);
 
-    // Allocate from the current chunk.
+    // Allocate from the current chunk. Chunks are reused after a reset, so
+    // the memory has to be cleared on every allocation.
+    chunk->offset = M_ArenaAlignOffset(chunk);
     void *const result = (char *)chunk->memory + chunk->offset;
     chunk->offset += size;
+    memset(result, 0, size);
     return result;
 }
 
@@ -122,4 +141,6 @@ void Memory_ArenaFree(MEMORY_ARENA_ALLOCATOR *const allocator)
         Memory_Free(chunk);
         chunk = next;
     }
+    allocator->first_chunk = nullptr;
+    allocator->current_chunk = nullptr;
 }
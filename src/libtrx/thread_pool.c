@@ -0,0 +1,172 @@
+#include "thread_pool.h"
+
+#include "debug.h"
+#include "log.h"
+#include "memory.h"
+
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_cpuinfo.h>
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_thread.h>
+
+struct THREAD_POOL {
+    int32_t worker_count;
+    SDL_Thread **workers;
+    SDL_mutex *mutex;
+    SDL_cond *work_cond;
+    SDL_cond *done_cond;
+    bool is_quitting;
+    bool is_running;
+    uint32_t generation;
+    int32_t busy_count;
+
+    THREAD_POOL_TASK task;
+    void *arg;
+    int32_t task_count;
+    SDL_atomic_t next_task;
+};
+
+static void M_RunTasks(THREAD_POOL *pool);
+static int M_Worker(void *arg);
+
+static void M_RunTasks(THREAD_POOL *const pool)
+{
+    while (true) {
+        const int32_t task_idx = SDL_AtomicAdd(&pool->next_task, 1);
+        if (task_idx >= pool->task_count) {
+            break;
+        }
+        pool->task(pool->arg, task_idx);
+    }
+}
+
+static int M_Worker(void *const arg)
+{
+    THREAD_POOL *const pool = arg;
+    uint32_t generation = 0;
+
+    SDL_LockMutex(pool->mutex);
+    while (true) {
+        while (!pool->is_quitting && pool->generation == generation) {
+            SDL_CondWait(pool->work_cond, pool->mutex);
+        }
+        if (pool->is_quitting) {
+            break;
+        }
+        generation = pool->generation;
+        SDL_UnlockMutex(pool->mutex);
+
+        M_RunTasks(pool);
+
+        SDL_LockMutex(pool->mutex);
+        pool->busy_count--;
+        if (pool->busy_count == 0) {
+            SDL_CondSignal(pool->done_cond);
+        }
+    }
+    SDL_UnlockMutex(pool->mutex);
+    return 0;
+}
+
+THREAD_POOL *ThreadPool_Create(const char *const name, int32_t worker_count)
+{
+    if (worker_count < 0) {
+        worker_count = SDL_GetCPUCount() - 1;
+    }
+
+    THREAD_POOL *const pool = Memory_Alloc(sizeof(THREAD_POOL));
+    pool->mutex = SDL_CreateMutex();
+    pool->work_cond = SDL_CreateCond();
+    pool->done_cond = SDL_CreateCond();
+    if (pool->mutex == nullptr || pool->work_cond == nullptr
+        || pool->done_cond == nullptr) {
+        LOG_ERROR("Failed to create thread pool: %s", SDL_GetError());
+        worker_count = 0;
+    }
+
+    if (worker_count > 0) {
+        pool->workers = Memory_Alloc(sizeof(SDL_Thread *) * worker_count);
+    }
+    for (int32_t i = 0; i < worker_count; i++) {
+        SDL_Thread *const thread = SDL_CreateThread(M_Worker, name, pool);
+        if (thread == nullptr) {
+            LOG_ERROR("SDL_CreateThread(): %s", SDL_GetError());
+            break;
+        }
+        pool->workers[pool->worker_count++] = thread;
+    }
+
+    LOG_INFO("Created %s with %d workers", name, pool->worker_count);
+    return pool;
+}
+
+void ThreadPool_Free(THREAD_POOL *const pool)
+{
+    if (pool == nullptr) {
+        return;
+    }
+
+    if (pool->worker_count > 0) {
+        SDL_LockMutex(pool->mutex);
+        pool->is_quitting = true;
+        SDL_CondBroadcast(pool->work_cond);
+        SDL_UnlockMutex(pool->mutex);
+        for (int32_t i = 0; i < pool->worker_count; i++) {
+            SDL_WaitThread(pool->workers[i], nullptr);
+        }
+    }
+
+    Memory_FreePointer(&pool->workers);
+    if (pool->done_cond != nullptr) {
+        SDL_DestroyCond(pool->done_cond);
+    }
+    if (pool->work_cond != nullptr) {
+        SDL_DestroyCond(pool->work_cond);
+    }
+    if (pool->mutex != nullptr) {
+        SDL_DestroyMutex(pool->mutex);
+    }
+    Memory_Free(pool);
+}
+
+int32_t ThreadPool_GetThreadCount(const THREAD_POOL *const pool)
+{
+    return pool == nullptr ? 1 : pool->worker_count + 1;
+}
+
+void ThreadPool_Run(
+    THREAD_POOL *const pool, const int32_t task_count,
+    const THREAD_POOL_TASK task, void *const arg)
+{
+    if (task_count <= 0) {
+        return;
+    }
+
+    if (pool == nullptr || pool->worker_count == 0 || task_count == 1) {
+        for (int32_t i = 0; i < task_count; i++) {
+            task(arg, i);
+        }
+        return;
+    }
+
+    ASSERT(!pool->is_running);
+    SDL_LockMutex(pool->mutex);
+    pool->is_running = true;
+    pool->task = task;
+    pool->arg = arg;
+    pool->task_count = task_count;
+    SDL_AtomicSet(&pool->next_task, 0);
+    pool->busy_count = pool->worker_count;
+    pool->generation++;
+    SDL_CondBroadcast(pool->work_cond);
+    SDL_UnlockMutex(pool->mutex);
+
+    M_RunTasks(pool);
+
+    SDL_LockMutex(pool->mutex);
+    while (pool->busy_count > 0) {
+        SDL_CondWait(pool->done_cond, pool->mutex);
+    }
+    pool->is_running = false;
+    SDL_UnlockMutex(pool->mutex);
+}
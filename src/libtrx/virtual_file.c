@@ -7,8 +7,101 @@
 
 #include <string.h>
 
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+static char *M_MapFile(const char *path, size_t *out_size);
+static void M_UnmapFile(char *data, size_t size);
+
+#if defined(_WIN32)
+static char *M_MapFile(const char *const path, size_t *const out_size)
+{
+    char *full_path = File_GetFullPath(path);
+    const HANDLE handle = CreateFileA(
+        full_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    Memory_FreePointer(&full_path);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    char *data = nullptr;
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(handle, &size) && size.QuadPart > 0
+        && (uint64_t)size.QuadPart <= SIZE_MAX) {
+        const HANDLE mapping =
+            CreateFileMappingA(handle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(handle);
+
+    if (data != nullptr) {
+        *out_size = (size_t)size.QuadPart;
+    }
+    return data;
+}
+
+// The size is only needed by munmap; a view is always unmapped whole here.
+static void M_UnmapFile(char *const data, const size_t size)
+{
+    UnmapViewOfFile(data);
+}
+#else
+static char *M_MapFile(const char *const path, size_t *const out_size)
+{
+    char *full_path = File_GetFullPath(path);
+    const int fd = open(full_path, O_RDONLY);
+    Memory_FreePointer(&full_path);
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    char *data = nullptr;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0
+        && (uint64_t)st.st_size <= SIZE_MAX) {
+        data = mmap(
+            nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            data = nullptr;
+        }
+    }
+    close(fd);
+
+    if (data != nullptr) {
+        *out_size = st.st_size;
+    }
+    return data;
+}
+
+static void M_UnmapFile(char *const data, const size_t size)
+{
+    munmap(data, size);
+}
+#endif
+
 VFILE *VFile_CreateFromPath(const char *const path)
 {
+    size_t mapped_size;
+    char *const mapped_data = M_MapFile(path, &mapped_size);
+    if (mapped_data != nullptr) {
+        VFILE *const file = Memory_Alloc(sizeof(VFILE));
+        file->content = mapped_data;
+        file->size = mapped_size;
+        file->cur_ptr = file->content;
+        file->is_mapped = true;
+        return file;
+    }
+
     MYFILE *fp = File_Open(path, FILE_OPEN_READ);
     if (!fp) {
         LOG_ERROR("Can't open file %s", path);
@@ -45,7 +138,12 @@ VFILE *VFile_CreateFromBuffer(const char *data, size_t size)
 void VFile_Close(VFILE *file)
 {
     ASSERT(file != nullptr);
-    Memory_FreePointer(&file->content);
+    if (file->is_mapped) {
+        M_UnmapFile(file->content, file->size);
+        file->content = nullptr;
+    } else {
+        Memory_FreePointer(&file->content);
+    }
     Memory_FreePointer(&file);
 }
 
@@ -133,6 +231,19 @@ uint32_t VFile_ReadU32(VFILE *file)
     return result;
 }
 
+const void *VFile_ReadView(VFILE *const file, const size_t size)
+{
+    const char *const result = file->cur_ptr;
+    VFile_Skip(file, size);
+    return result;
+}
+
+void VFile_ReadS16Array(
+    VFILE *const file, int16_t *const target, const size_t count)
+{
+    VFile_Read(file, target, sizeof(int16_t) * count);
+}
+
 #define DEFINE_TRY_READ(name, type)                                            \
     bool name(VFILE *const file, type *const dst)                              \
     {                                                                          \
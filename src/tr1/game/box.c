@@ -5,19 +5,105 @@
 #include "global/const.h"
 #include "global/vars.h"
 
+#include <libtrx/game/game_buf.h>
 #include <libtrx/utils.h>
 
-bool Box_SearchLOT(LOT_INFO *lot, int32_t expansion)
+typedef enum {
+    M_ZONE_GROUND,
+    M_ZONE_GROUND_2,
+    M_ZONE_FLY,
+    M_ZONE_TYPES,
+} M_ZONE_TYPE;
+
+// Overlaps of every box in CSR form: the neighbours of box b are the entries
+// in [starts[b], starts[b + 1]). The neighbour heights and zones are copied
+// next to the box numbers so that the flood does not touch g_Boxes for the
+// neighbours it rejects.
+static struct {
+    int32_t *starts;
+    int16_t *boxes;
+    int16_t *heights;
+    int16_t *zones[2][M_ZONE_TYPES];
+} m_Adjacency = {};
+
+static M_ZONE_TYPE M_GetZoneType(const LOT_INFO *lot);
+static int16_t *M_GetZone(M_ZONE_TYPE zone_type, bool flip_status);
+
+static M_ZONE_TYPE M_GetZoneType(const LOT_INFO *const lot)
 {
-    const bool flip_status = Room_GetFlipStatus();
-    int16_t *zone;
     if (lot->fly) {
-        zone = g_FlyZone[flip_status];
+        return M_ZONE_FLY;
     } else if (lot->step == STEP_L) {
-        zone = g_GroundZone[flip_status];
-    } else {
-        zone = g_GroundZone2[flip_status];
+        return M_ZONE_GROUND;
+    }
+    return M_ZONE_GROUND_2;
+}
+
+static int16_t *M_GetZone(const M_ZONE_TYPE zone_type, const bool flip_status)
+{
+    switch (zone_type) {
+    case M_ZONE_GROUND:
+        return g_GroundZone[flip_status];
+    case M_ZONE_GROUND_2:
+        return g_GroundZone2[flip_status];
+    default:
+        return g_FlyZone[flip_status];
+    }
+}
+
+void Box_InitialiseAdjacency(void)
+{
+    m_Adjacency.starts = GameBuf_Alloc(
+        sizeof(int32_t) * (g_NumberBoxes + 1), GBUF_BOX_ADJACENCY);
+
+    int32_t edge_count = 0;
+    for (int32_t i = 0; i < g_NumberBoxes; i++) {
+        m_Adjacency.starts[i] = edge_count;
+        int32_t index = g_Boxes[i].overlap_index & OVERLAP_INDEX;
+        do {
+            edge_count++;
+        } while (!(g_Overlap[index++] & END_BIT));
+    }
+    m_Adjacency.starts[g_NumberBoxes] = edge_count;
+
+    m_Adjacency.boxes =
+        GameBuf_Alloc(sizeof(int16_t) * edge_count, GBUF_BOX_ADJACENCY);
+    m_Adjacency.heights =
+        GameBuf_Alloc(sizeof(int16_t) * edge_count, GBUF_BOX_ADJACENCY);
+    for (int32_t i = 0; i < 2; i++) {
+        for (int32_t j = 0; j < M_ZONE_TYPES; j++) {
+            m_Adjacency.zones[i][j] = GameBuf_Alloc(
+                sizeof(int16_t) * edge_count, GBUF_BOX_ADJACENCY);
+        }
+    }
+
+    for (int32_t i = 0; i < g_NumberBoxes; i++) {
+        int32_t index = g_Boxes[i].overlap_index & OVERLAP_INDEX;
+        const int32_t end = m_Adjacency.starts[i + 1];
+        for (int32_t j = m_Adjacency.starts[i]; j < end; j++) {
+            const int16_t box_num = g_Overlap[index++] & BOX_NUMBER;
+            m_Adjacency.boxes[j] = box_num;
+            m_Adjacency.heights[j] = g_Boxes[box_num].height;
+            for (int32_t k = 0; k < 2; k++) {
+                for (int32_t l = 0; l < M_ZONE_TYPES; l++) {
+                    m_Adjacency.zones[k][l][j] = M_GetZone(l, k)[box_num];
+                }
+            }
+        }
     }
+}
+
+// Each creature runs its own incremental flood on purpose. Until a search
+// finishes, creatures steer by the partial exit_box chain and the blocked
+// search numbers. That state is also stored in savegames, so sharing a
+// finished distance field between creatures would change AI movement and
+// break demos and existing saves.
+bool Box_SearchLOT(LOT_INFO *lot, int32_t expansion)
+{
+    const bool flip_status = Room_GetFlipStatus();
+    const M_ZONE_TYPE zone_type = M_GetZoneType(lot);
+    const int16_t *const zone = M_GetZone(zone_type, flip_status);
+    const int16_t *const edge_zone = m_Adjacency.zones[flip_status][zone_type];
 
     int16_t search_zone = zone[lot->head];
     for (int i = 0; i < expansion; i++) {
@@ -26,26 +112,20 @@ bool Box_SearchLOT(LOT_INFO *lot, int32_t expansion)
         }
 
         BOX_NODE *node = &lot->node[lot->head];
-        BOX_INFO *box = &g_Boxes[lot->head];
-
-        int done = 0;
-        int index = box->overlap_index & OVERLAP_INDEX;
-        do {
-            int16_t box_num = g_Overlap[index++];
-            if (box_num & END_BIT) {
-                done = 1;
-                box_num &= BOX_NUMBER;
-            }
+        const int16_t height = g_Boxes[lot->head].height;
 
-            if (search_zone != zone[box_num]) {
+        const int32_t end = m_Adjacency.starts[lot->head + 1];
+        for (int32_t j = m_Adjacency.starts[lot->head]; j < end; j++) {
+            if (search_zone != edge_zone[j]) {
                 continue;
             }
 
-            int change = g_Boxes[box_num].height - box->height;
+            int change = m_Adjacency.heights[j] - height;
             if (change > lot->step || change < lot->drop) {
                 continue;
             }
 
+            const int16_t box_num = m_Adjacency.boxes[j];
             BOX_NODE *expand = &lot->node[box_num];
             if ((node->search_num & SEARCH_NUMBER)
                 < (expand->search_num & SEARCH_NUMBER)) {
@@ -77,7 +157,7 @@ bool Box_SearchLOT(LOT_INFO *lot, int32_t expansion)
                 lot->node[lot->tail].next_expansion = box_num;
                 lot->tail = box_num;
             }
-        } while (!done);
+        }
 
         lot->head = node->next_expansion;
         node->next_expansion = NO_BOX;
@@ -180,15 +260,8 @@ bool Box_ValidBox(ITEM *item, int16_t zone_num, int16_t box_num)
 {
     CREATURE *creature = item->data;
 
-    const bool flip_status = Room_GetFlipStatus();
-    int16_t *zone;
-    if (creature->lot.fly) {
-        zone = g_FlyZone[flip_status];
-    } else if (creature->lot.step == STEP_L) {
-        zone = g_GroundZone[flip_status];
-    } else {
-        zone = g_GroundZone2[flip_status];
-    }
+    const int16_t *const zone =
+        M_GetZone(M_GetZoneType(&creature->lot), Room_GetFlipStatus());
 
     if (zone[box_num] != zone_num) {
         return false;
@@ -4,6 +4,8 @@
 
 #include <stdint.h>
 
+// Must be called after the level boxes and overlaps are final.
+void Box_InitialiseAdjacency(void);
 bool Box_SearchLOT(LOT_INFO *lot, int32_t expansion);
 bool Box_UpdateLOT(LOT_INFO *lot, int32_t expansion);
 void Box_TargetBox(LOT_INFO *lot, int16_t box_num);
@@ -22,36 +22,8 @@ void Collide_GetCollisionInfo(
     coll->shift.z = 0;
     coll->quadrant = (uint16_t)(coll->facing + DEG_45) / DEG_90;
 
-    int32_t x = xpos;
-    int32_t y = ypos - obj_height;
-    int32_t z = zpos;
-    int32_t ytop = y - 160;
-
-    const SECTOR *sector = Room_GetSector(x, ytop, z, &room_num);
-    int32_t height = Room_GetHeight(sector, x, ytop, z);
-    int32_t room_height = height;
-    if (height != NO_HEIGHT) {
-        height -= ypos;
-    }
-
-    int32_t ceiling = Room_GetCeiling(sector, x, ytop, z);
-    if (ceiling != NO_HEIGHT) {
-        ceiling -= y;
-    }
-
-    coll->mid_floor = height;
-    coll->mid_ceiling = ceiling;
-    coll->mid_type = g_HeightType;
-
-    if (!g_Config.gameplay.fix_bridge_collision
-        || !Room_IsOnWalkable(sector, x, ytop, z, room_height)) {
-        const int16_t tilt = Room_GetTiltType(sector, x, g_LaraItem->pos.y, z);
-        coll->tilt_z = tilt >> 8;
-        coll->tilt_x = (int8_t)tilt;
-    } else {
-        coll->tilt_z = 0;
-        coll->tilt_x = 0;
-    }
+    const int32_t y = ypos - obj_height;
+    const int32_t ytop = y - 160;
 
     int32_t xleft;
     int32_t zleft;
@@ -106,27 +78,61 @@ void Collide_GetCollisionInfo(
         break;
     }
 
-    // Front.
-    x = xpos + xfront;
-    z = zpos + zfront;
-    sector = Room_GetSector(x, ytop, z, &room_num);
-    height = Room_GetHeight(sector, x, ytop, z);
-    room_height = height;
-    if (height != NO_HEIGHT) {
-        height -= ypos;
-    }
+    ROOM_HEIGHT_QUERY queries[] = {
+        { .x = xpos, .y = ytop, .z = zpos, .room_num = room_num },
+        {
+            .x = xpos + xfront,
+            .y = ytop,
+            .z = zpos + zfront,
+            .room_num = NO_ROOM,
+        },
+        {
+            .x = xpos + xleft,
+            .y = ytop,
+            .z = zpos + zleft,
+            .room_num = NO_ROOM,
+        },
+        {
+            .x = xpos + xright,
+            .y = ytop,
+            .z = zpos + zright,
+            .room_num = NO_ROOM,
+        },
+    };
+    Room_GetHeights(queries, 4);
+    room_num = queries[3].room_num;
+
+    // Middle.
+    const ROOM_HEIGHT_QUERY *query = &queries[0];
+    coll->mid_floor =
+        query->floor != NO_HEIGHT ? query->floor - ypos : NO_HEIGHT;
+    coll->mid_ceiling =
+        query->ceiling != NO_HEIGHT ? query->ceiling - y : NO_HEIGHT;
+    coll->mid_type = query->height_type;
 
-    ceiling = Room_GetCeiling(sector, x, ytop, z);
-    if (ceiling != NO_HEIGHT) {
-        ceiling -= y;
+    if (!g_Config.gameplay.fix_bridge_collision
+        || !Room_IsOnWalkable(
+            query->sector, query->x, ytop, query->z, query->floor)) {
+        const int16_t tilt = Room_GetTiltType(
+            query->sector, query->x, g_LaraItem->pos.y, query->z);
+        coll->tilt_z = tilt >> 8;
+        coll->tilt_x = (int8_t)tilt;
+    } else {
+        coll->tilt_z = 0;
+        coll->tilt_x = 0;
     }
 
-    coll->front_floor = height;
-    coll->front_ceiling = ceiling;
-    coll->front_type = g_HeightType;
+    // Front.
+    query = &queries[1];
+    coll->front_floor =
+        query->floor != NO_HEIGHT ? query->floor - ypos : NO_HEIGHT;
+    coll->front_ceiling =
+        query->ceiling != NO_HEIGHT ? query->ceiling - y : NO_HEIGHT;
+    coll->front_type = query->height_type;
 
     if (!g_Config.gameplay.fix_bridge_collision
-        || !Room_IsOnWalkable(sector, x, ytop, z, room_height)) {
+        || !Room_IsOnWalkable(
+            query->sector, query->x, ytop, query->z, query->floor)) {
         if (coll->slopes_are_walls && coll->front_type == HT_BIG_SLOPE
             && coll->front_floor < 0) {
             coll->front_floor = -32767;
@@ -136,32 +142,23 @@ void Collide_GetCollisionInfo(
             coll->front_floor = 512;
         } else if (
             coll->lava_is_pit && coll->front_floor > 0
-            && Room_GetPitSector(sector, x, z)->is_death_sector) {
+            && Room_GetPitSector(query->sector, query->x, query->z)
+                   ->is_death_sector) {
             coll->front_floor = 512;
         }
     }
 
     // Left.
-    x = xpos + xleft;
-    z = zpos + zleft;
-    sector = Room_GetSector(x, ytop, z, &room_num);
-    height = Room_GetHeight(sector, x, ytop, z);
-    room_height = height;
-    if (height != NO_HEIGHT) {
-        height -= ypos;
-    }
-
-    ceiling = Room_GetCeiling(sector, x, ytop, z);
-    if (ceiling != NO_HEIGHT) {
-        ceiling -= y;
-    }
-
-    coll->left_floor = height;
-    coll->left_ceiling = ceiling;
-    coll->left_type = g_HeightType;
+    query = &queries[2];
+    coll->left_floor =
+        query->floor != NO_HEIGHT ? query->floor - ypos : NO_HEIGHT;
+    coll->left_ceiling =
+        query->ceiling != NO_HEIGHT ? query->ceiling - y : NO_HEIGHT;
+    coll->left_type = query->height_type;
 
     if (!g_Config.gameplay.fix_bridge_collision
-        || !Room_IsOnWalkable(sector, x, ytop, z, room_height)) {
+        || !Room_IsOnWalkable(
+            query->sector, query->x, ytop, query->z, query->floor)) {
         if (coll->slopes_are_walls && coll->left_type == HT_BIG_SLOPE
             && coll->left_floor < 0) {
             coll->left_floor = -32767;
@@ -171,32 +168,23 @@ void Collide_GetCollisionInfo(
             coll->left_floor = 512;
         } else if (
             coll->lava_is_pit && coll->left_floor > 0
-            && Room_GetPitSector(sector, x, z)->is_death_sector) {
+            && Room_GetPitSector(query->sector, query->x, query->z)
+                   ->is_death_sector) {
             coll->left_floor = 512;
         }
     }
 
     // Right.
-    x = xpos + xright;
-    z = zpos + zright;
-    sector = Room_GetSector(x, ytop, z, &room_num);
-    height = Room_GetHeight(sector, x, ytop, z);
-    room_height = height;
-    if (height != NO_HEIGHT) {
-        height -= ypos;
-    }
-
-    ceiling = Room_GetCeiling(sector, x, ytop, z);
-    if (ceiling != NO_HEIGHT) {
-        ceiling -= y;
-    }
-
-    coll->right_floor = height;
-    coll->right_ceiling = ceiling;
-    coll->right_type = g_HeightType;
+    query = &queries[3];
+    coll->right_floor =
+        query->floor != NO_HEIGHT ? query->floor - ypos : NO_HEIGHT;
+    coll->right_ceiling =
+        query->ceiling != NO_HEIGHT ? query->ceiling - y : NO_HEIGHT;
+    coll->right_type = query->height_type;
 
     if (!g_Config.gameplay.fix_bridge_collision
-        || !Room_IsOnWalkable(sector, x, ytop, z, room_height)) {
+        || !Room_IsOnWalkable(
+            query->sector, query->x, ytop, query->z, query->floor)) {
         if (coll->slopes_are_walls && coll->right_type == HT_BIG_SLOPE
             && coll->right_floor < 0) {
             coll->right_floor = -32767;
@@ -206,14 +194,15 @@ void Collide_GetCollisionInfo(
             coll->right_floor = 512;
         } else if (
             coll->lava_is_pit && coll->right_floor > 0
-            && Room_GetPitSector(sector, x, z)->is_death_sector) {
+            && Room_GetPitSector(query->sector, query->x, query->z)
+                   ->is_death_sector) {
             coll->right_floor = 512;
         }
     }
 
     if (Collide_CollideStaticObjects(
             coll, xpos, ypos, zpos, room_num, obj_height)) {
-        sector = Room_GetSector(
+        const SECTOR *const sector = Room_GetSector(
             xpos + coll->shift.x, ypos, zpos + coll->shift.z, &room_num);
         if (Room_GetHeight(
                 sector, xpos + coll->shift.x, ypos, zpos + coll->shift.z)
@@ -276,8 +276,9 @@ static GF_COMMAND M_Finish(INV_RING *const ring, const bool apply_changes)
             };
 
         case PASSPORT_MODE_SAVE_GAME:
-            if (apply_changes) {
-                Savegame_Save(g_GameInfo.select_save_slot);
+            if (apply_changes && !Savegame_Save(g_GameInfo.select_save_slot)) {
+                Console_Log(
+                    GS(OSD_SAVE_GAME_FAIL), g_GameInfo.select_save_slot + 1);
             }
             return (GF_COMMAND) { .action = GF_NOOP };
 
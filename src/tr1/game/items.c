@@ -11,6 +11,7 @@
 #include "global/types.h"
 #include "global/vars.h"
 
+#include <libtrx/benchmark.h>
 #include <libtrx/config.h>
 #include <libtrx/game/math.h>
 #include <libtrx/game/matrix.h>
@@ -31,6 +32,7 @@ static BOUNDS_16 m_InterpolatedBounds = {};
 
 void Item_Control(void)
 {
+    Benchmark_BeginZone(BENCHMARK_ZONE_ITEM_CONTROL);
     int16_t item_num = Item_GetNextActive();
     while (item_num != NO_ITEM) {
         ITEM *item = Item_Get(item_num);
@@ -42,6 +44,7 @@ void Item_Control(void)
     }
 
     Carrier_AnimateDrops();
+    Benchmark_EndZone(BENCHMARK_ZONE_ITEM_CONTROL);
 }
 
 void Item_Initialise(int16_t item_num)
@@ -1,5 +1,6 @@
 #include "game/level.h"
 
+#include "game/box.h"
 #include "game/camera.h"
 #include "game/carrier.h"
 #include "game/effects.h"
@@ -48,11 +49,21 @@ typedef enum {
     LEVEL_LAYOUT_NUMBER_OF,
 } LEVEL_LAYOUT;
 
+// Sections of the level file that are read out of order.
+typedef enum {
+    LEVEL_SECTION_TEXTURE_PAGES,
+    LEVEL_SECTION_ROOMS, // starts with the file level number
+    LEVEL_SECTION_NUMBER_OF,
+} LEVEL_SECTION;
+
 static LEVEL_INFO m_LevelInfo = {};
 static INJECTION_INFO *m_InjectionInfo = nullptr;
+static size_t m_SectionOffsets[LEVEL_SECTION_NUMBER_OF] = {};
 
-static bool M_TryLayout(VFILE *file, LEVEL_LAYOUT layout);
+static bool M_TryReadCommonSections(VFILE *file);
+static bool M_TryReadLayoutSections(VFILE *file, LEVEL_LAYOUT layout);
 static LEVEL_LAYOUT M_GuessLayout(VFILE *file);
+static void M_SeekSection(VFILE *file, LEVEL_SECTION section);
 static void M_LoadFromFile(const GF_LEVEL *level);
 static void M_LoadObjectMeshes(VFILE *file);
 static void M_LoadAnims(VFILE *file);
@@ -69,8 +80,6 @@ static void M_CompleteSetup(const GF_LEVEL *level);
 static void M_MarkWaterEdgeVertices(void);
 static size_t M_CalculateMaxVertices(void);
 
-static bool M_TryLayout(VFILE *const file, const LEVEL_LAYOUT layout)
-{
 #define TRY_OR_FAIL(call)                                                      \
     if (!call) {                                                               \
         return false;                                                          \
@@ -87,7 +96,11 @@ static bool M_TryLayout(VFILE *const file, const LEVEL_LAYOUT layout)
         TRY_OR_FAIL(VFile_TryReadU16(file, &num));                             \
         TRY_OR_FAIL(VFile_TrySkip(file, num *size));                           \
     }
+#define MARK_SECTION(section) m_SectionOffsets[section] = VFile_GetPos(file)
 
+// Everything up to the sprite sequences is shared by all layouts.
+static bool M_TryReadCommonSections(VFILE *const file)
+{
     VFile_SetPos(file, 0);
 
     int32_t version;
@@ -98,7 +111,10 @@ static bool M_TryLayout(VFILE *const file, const LEVEL_LAYOUT layout)
         return false;
     }
 
+    MARK_SECTION(LEVEL_SECTION_TEXTURE_PAGES);
     TRY_OR_FAIL_ARR_S32(TEXTURE_PAGE_SIZE); // textures
+
+    MARK_SECTION(LEVEL_SECTION_ROOMS);
     TRY_OR_FAIL(VFile_TrySkip(file, 4));
 
     uint16_t room_count;
@@ -134,7 +150,13 @@ static bool M_TryLayout(VFILE *const file, const LEVEL_LAYOUT layout)
     TRY_OR_FAIL_ARR_S32(20); // textures
     TRY_OR_FAIL_ARR_S32(16); // sprites
     TRY_OR_FAIL_ARR_S32(8); // sprites sequences
+    return true;
+}
 
+// Reads the rest of the file, starting right after the sprite sequences.
+static bool M_TryReadLayoutSections(
+    VFILE *const file, const LEVEL_LAYOUT layout)
+{
     if (layout == LEVEL_LAYOUT_TR1_DEMO_PC) {
         TRY_OR_FAIL(VFile_TrySkip(file, 768)); // palette
     }
@@ -164,27 +186,41 @@ static bool M_TryLayout(VFILE *const file, const LEVEL_LAYOUT layout)
     TRY_OR_FAIL_ARR_S32(8); // sample infos
     TRY_OR_FAIL_ARR_S32(1); // sample data
     TRY_OR_FAIL_ARR_S32(4); // samples
+    return true;
+}
 
+#undef MARK_SECTION
 #undef TRY_OR_FAIL
 #undef TRY_OR_FAIL_ARR_U16
 #undef TRY_OR_FAIL_ARR_S32
-    return true;
-}
 
+// Walks the file once, recording where the sections that are read out of
+// order start. Only the short tail after the sprite sequences is tried again
+// for each layout.
 static LEVEL_LAYOUT M_GuessLayout(VFILE *const file)
 {
     LEVEL_LAYOUT result = LEVEL_LAYOUT_UNKNOWN;
     BENCHMARK *const benchmark = Benchmark_Start();
-    for (LEVEL_LAYOUT layout = 0; layout < LEVEL_LAYOUT_NUMBER_OF; layout++) {
-        if (M_TryLayout(file, layout)) {
-            result = layout;
-            break;
+    if (M_TryReadCommonSections(file)) {
+        const size_t layout_start = VFile_GetPos(file);
+        for (LEVEL_LAYOUT layout = 0; layout < LEVEL_LAYOUT_NUMBER_OF;
+             layout++) {
+            VFile_SetPos(file, layout_start);
+            if (M_TryReadLayoutSections(file, layout)) {
+                result = layout;
+                break;
+            }
         }
     }
     Benchmark_End(benchmark, nullptr);
     return result;
 }
 
+static void M_SeekSection(VFILE *const file, const LEVEL_SECTION section)
+{
+    VFile_SetPos(file, m_SectionOffsets[section]);
+}
+
 static void M_LoadFromFile(const GF_LEVEL *const level)
 {
     GameBuf_Reset();
@@ -198,14 +234,10 @@ static void M_LoadFromFile(const GF_LEVEL *const level)
     if (layout == LEVEL_LAYOUT_UNKNOWN) {
         Shell_ExitSystemFmt("Failed to load %s", level->path);
     }
-    VFile_SetPos(file, 4);
-
-    {
-        // Read texture pages once the palette is available.
-        const int32_t num_pages = VFile_ReadS32(file);
-        VFile_Skip(file, num_pages * TEXTURE_PAGE_SIZE * sizeof(uint8_t));
-    }
 
+    // Skip the texture pages for now. They are read later, once the palette
+    // is available, by seeking back to LEVEL_SECTION_TEXTURE_PAGES.
+    M_SeekSection(file, LEVEL_SECTION_ROOMS);
     const int32_t file_level_num = VFile_ReadS32(file);
     LOG_INFO("file level num: %d", file_level_num);
 
@@ -245,7 +277,7 @@ static void M_LoadFromFile(const GF_LEVEL *const level)
         &m_LevelInfo, m_InjectionInfo->sfx_count,
         m_InjectionInfo->sfx_data_size, m_InjectionInfo->sample_count, file);
 
-    VFile_SetPos(file, 4);
+    M_SeekSection(file, LEVEL_SECTION_TEXTURE_PAGES);
     Level_ReadTexturePages(
         &m_LevelInfo, m_InjectionInfo->texture_page_count, file);
 
@@ -437,6 +469,9 @@ static void M_CompleteSetup(const GF_LEVEL *const level)
     Mutant_ToggleExplosions(Object_Get(O_EXPLOSION_1)->loaded);
 
     Inject_AllInjections(&m_LevelInfo);
+    Room_RebuildGrid();
+    Room_ResetSectorCache();
+    Box_InitialiseAdjacency();
 
     Level_LoadAnimFrames(&m_LevelInfo);
     Level_LoadAnimCommands();
@@ -460,6 +495,7 @@ static void M_CompleteSetup(const GF_LEVEL *const level)
     Level_LoadTexturePages(&m_LevelInfo);
     Level_LoadPalettes(&m_LevelInfo);
     Output_DownloadTextures(m_LevelInfo.textures.page_count);
+    Output_DownloadRoomMeshes();
 
     // Initialise the sound effects.
     const int32_t sample_count = m_LevelInfo.samples.offset_count;
@@ -549,6 +585,7 @@ void Level_Load(const GF_LEVEL *const level)
 {
     LOG_INFO("%d (%s)", level->num, level->path);
     BENCHMARK *const benchmark = Benchmark_Start();
+    GF_CancelPrefetch();
 
     m_InjectionInfo = Memory_Alloc(sizeof(INJECTION_INFO));
     Inject_Init(
@@ -27,6 +27,15 @@
 
 #define MAX_LIGHTNINGS 64
 #define PHD_IONE (PHD_ONE / 4)
+#define VERTEX_BATCH 8
+
+// Room vertices are transformed in batches, one vector lane per vertex.
+typedef int32_t M_VEC_I32
+    __attribute__((vector_size(VERTEX_BATCH * sizeof(int32_t))));
+typedef int64_t M_VEC_I64
+    __attribute__((vector_size(VERTEX_BATCH * sizeof(int64_t))));
+typedef double M_VEC_F64
+    __attribute__((vector_size(VERTEX_BATCH * sizeof(double))));
 
 typedef struct {
     struct {
@@ -41,6 +50,17 @@ typedef struct {
     XYZ_16 vertices[32];
 } SHADOW_INFO;
 
+typedef struct {
+    int32_t first_index;
+    int32_t index_count;
+} ROOM_MESH_RANGE;
+
+typedef struct {
+    uint16_t texture_idx;
+    int16_t vertex_count;
+    int32_t first_vertex;
+} ANIMATED_FACE;
+
 static int32_t m_LsAdder = 0;
 static int32_t m_LsDivider = 0;
 static bool m_IsSkyboxEnabled = false;
@@ -71,6 +91,20 @@ static XYZ_32 m_LsVectorView = {};
 static int32_t m_LightningCount = 0;
 static LIGHTNING m_LightningTable[MAX_LIGHTNINGS];
 
+// Room geometry that lives on the GPU. Faces with animated textures have
+// their vertices at the end of the buffer, so that they can be refreshed
+// together whenever the textures cycle.
+static struct {
+    bool is_loaded;
+    ROOM_MESH_RANGE *ranges;
+    int32_t anim_first_vertex;
+    int32_t anim_vertex_count;
+    GFX_3D_MESH_VERTEX *anim_vertices;
+    int32_t anim_face_count;
+    ANIMATED_FACE *anim_faces;
+    bool is_anim_dirty;
+} m_RoomMeshes = {};
+
 static char *m_BackdropImagePath = nullptr;
 static const char *m_ImageExtensions[] = {
     ".png", ".jpg", ".jpeg", ".pcx", nullptr,
@@ -89,9 +123,18 @@ static bool M_CalcObjectVertices(const XYZ_16 *vertices, int16_t count);
 static void M_CalcVerticeLight(const OBJECT_MESH *mesh);
 static bool M_CalcVerticeEnvMap(const OBJECT_MESH *mesh);
 static void M_CalcSkyboxLight(const OBJECT_MESH *mesh);
+static void M_CalcRoomVertexBatch(
+    const ROOM_MESH *mesh, int32_t start, int32_t count);
 static void M_CalcRoomVertices(const ROOM_MESH *mesh);
 static void M_CalcRoomVerticesWibble(const ROOM_MESH *mesh);
 static void M_CalcWibbleTable(void);
+static bool *M_GetAnimatedTextures(void);
+static void M_FillRoomMeshVertex(
+    GFX_3D_MESH_VERTEX *out, const ROOM_VERTEX *vertex,
+    const OBJECT_TEXTURE *tex, int32_t corner);
+static void M_ReleaseRoomMeshes(void);
+static void M_UpdateAnimatedRoomMeshes(void);
+static bool M_DrawRoomMesh(const ROOM *room);
 
 static void M_DrawFlatFace3s(const FACE3 *const faces, const int32_t count)
 {
@@ -444,38 +487,114 @@ static void M_CalcSkyboxLight(const OBJECT_MESH *const mesh)
     }
 }
 
-static void M_CalcRoomVertices(const ROOM_MESH *const mesh)
+static void M_CalcRoomVertexBatch(
+    const ROOM_MESH *const mesh, const int32_t start, const int32_t count)
 {
-    for (int32_t i = 0; i < mesh->num_vertices; i++) {
-        PHD_VBUF *const vbuf = &m_VBuf[i];
+    M_VEC_I32 x = {};
+    M_VEC_I32 y = {};
+    M_VEC_I32 z = {};
+    M_VEC_I32 shade = {};
+    M_VEC_I32 water_shade = {};
+    for (int32_t j = 0; j < count; j++) {
+        const int32_t i = start + j;
         const ROOM_VERTEX *const vertex = &mesh->vertices[i];
-
-        M_CalcVertex(vbuf, vertex->pos);
-
-        vbuf->g = vertex->light_adder;
-        if (vbuf->zv >= Output_GetNearZ()) {
-            const int32_t depth = ((int32_t)vbuf->zv) >> W2V_SHIFT;
-            if (depth > Output_GetDrawDistMax()) {
-                vbuf->g = MAX_LIGHTING;
-                if (!m_IsSkyboxEnabled) {
-                    vbuf->clip |= 16;
-                }
-            } else {
-                vbuf->g += Output_CalcFogShade(depth);
-                if (!m_IsWaterEffect) {
-                    CLAMPG(vbuf->g, MAX_LIGHTING);
-                }
-            }
-        }
-
+        x[j] = vertex->pos.x;
+        y[j] = vertex->pos.y;
+        z[j] = vertex->pos.z;
+        shade[j] = vertex->light_adder;
         if (m_IsWaterEffect) {
-            vbuf->g += m_ShadeTable[(
+            water_shade[j] = m_ShadeTable[(
                 ((uint8_t)m_WibbleOffset
                  + (uint8_t)m_RandTable[(mesh->num_vertices - i) % WIBBLE_SIZE])
                 % WIBBLE_SIZE)];
-            CLAMP(vbuf->g, 0, 0x1FFF);
         }
     }
+
+    // clang-format off
+    const MATRIX *const mptr = g_MatrixPtr;
+    const M_VEC_F64 xv = __builtin_convertvector(
+        mptr->_00 * x + mptr->_01 * y + mptr->_02 * z + mptr->_03,
+        M_VEC_F64);
+    const M_VEC_F64 yv = __builtin_convertvector(
+        mptr->_10 * x + mptr->_11 * y + mptr->_12 * z + mptr->_13,
+        M_VEC_F64);
+    const M_VEC_I32 zv_int =
+        mptr->_20 * x + mptr->_21 * y + mptr->_22 * z + mptr->_23;
+    const M_VEC_F64 zv = __builtin_convertvector(zv_int, M_VEC_F64);
+    // clang-format on
+
+    // Unused lanes and lanes behind the near plane are projected too, but
+    // their results are never stored.
+    const M_VEC_F64 persp = (double)g_PhdPersp / zv;
+    const M_VEC_F64 xs = (double)Viewport_GetCenterX() + xv * persp;
+    const M_VEC_F64 ys = (double)Viewport_GetCenterY() + yv * persp;
+    const M_VEC_I32 depth = zv_int >> W2V_SHIFT;
+
+    // Comparisons set all bits of the lanes for which they hold.
+    const M_VEC_I64 is_near = (M_VEC_I64)(zv < (double)Output_GetNearZ());
+    const M_VEC_I32 is_near_i32 = __builtin_convertvector(is_near, M_VEC_I32);
+    const M_VEC_I32 is_far =
+        ~is_near_i32 & (depth > Output_GetDrawDistMax());
+    const M_VEC_I64 is_far_i64 = __builtin_convertvector(is_far, M_VEC_I64);
+    const M_VEC_I64 clip = (is_near & 0x8000)
+        | (is_far_i64 & (m_IsSkyboxEnabled ? 0 : 16))
+        | (~is_near
+           & (((M_VEC_I64)(xs < (double)g_PhdLeft) & 1)
+              | ((M_VEC_I64)(xs > (double)g_PhdRight) & 2)
+              | ((M_VEC_I64)(ys < (double)g_PhdTop) & 4)
+              | ((M_VEC_I64)(ys > (double)g_PhdBottom) & 8)));
+
+    // Matches Output_CalcFogShade lane by lane. The depth is clamped to the
+    // fog range first so that lanes outside of it cannot overflow.
+    const int32_t fog_begin = Output_GetDrawDistFade();
+    const int32_t fog_end = Output_GetDrawDistMax();
+    const int32_t fog_range = MAX(fog_end - fog_begin, 1);
+    const M_VEC_I32 is_clear = depth < fog_begin;
+    const M_VEC_I32 is_opaque = ~is_clear & (depth >= fog_end);
+    M_VEC_I32 fog_depth = depth - fog_begin;
+    fog_depth &= ~is_clear;
+    const M_VEC_I32 is_beyond = fog_depth > fog_range;
+    fog_depth = (is_beyond & fog_range) | (~is_beyond & fog_depth);
+    const M_VEC_I32 fog = (is_opaque & 0x1FFF)
+        | (~is_clear & ~is_opaque & (fog_depth * 0x1FFF / fog_range));
+
+    // Lanes in front of the near plane are either fogged or fully lit; lanes
+    // behind it keep their shade. Only the water effect clamps those too.
+    const M_VEC_I32 is_fog = ~is_near_i32 & ~is_far;
+    shade += is_fog & fog;
+    shade = (is_far & MAX_LIGHTING) | (~is_far & shade);
+    M_VEC_I32 is_bright;
+    if (m_IsWaterEffect) {
+        shade += water_shade;
+        shade &= ~(shade < 0);
+        is_bright = shade > 0x1FFF;
+    } else {
+        is_bright = is_fog & (shade > MAX_LIGHTING);
+    }
+    shade = (is_bright & MAX_LIGHTING) | (~is_bright & shade);
+
+    for (int32_t j = 0; j < count; j++) {
+        PHD_VBUF *const vbuf = &m_VBuf[start + j];
+        vbuf->xv = xv[j];
+        vbuf->yv = yv[j];
+        vbuf->zv = zv[j];
+        vbuf->clip = clip[j];
+        // Projections behind the near plane are meaningless, so those lanes
+        // are left alone rather than overwritten.
+        if (!is_near[j]) {
+            vbuf->xs = xs[j];
+            vbuf->ys = ys[j];
+        }
+        vbuf->g = shade[j];
+    }
+}
+
+static void M_CalcRoomVertices(const ROOM_MESH *const mesh)
+{
+    for (int32_t i = 0; i < mesh->num_vertices; i += VERTEX_BATCH) {
+        M_CalcRoomVertexBatch(
+            mesh, i, MIN(VERTEX_BATCH, mesh->num_vertices - i));
+    }
 }
 
 static void M_CalcRoomVerticesWibble(const ROOM_MESH *const mesh)
@@ -498,6 +617,82 @@ static void M_CalcWibbleTable(void)
     }
 }
 
+static bool *M_GetAnimatedTextures(void)
+{
+    const int32_t texture_count = Output_GetObjectTextureCount();
+    bool *const is_animated = Memory_Alloc(sizeof(bool) * texture_count);
+    const ANIMATED_TEXTURE_RANGE *range = Output_GetAnimatedTextureRange(0);
+    for (; range != nullptr; range = range->next_range) {
+        for (int32_t i = 0; i < range->num_textures; i++) {
+            is_animated[range->textures[i]] = true;
+        }
+    }
+    return is_animated;
+}
+
+static void M_FillRoomMeshVertex(
+    GFX_3D_MESH_VERTEX *const out, const ROOM_VERTEX *const vertex,
+    const OBJECT_TEXTURE *const tex, const int32_t corner)
+{
+    out->x = vertex->pos.x;
+    out->y = vertex->pos.y;
+    out->z = vertex->pos.z;
+    out->u = tex->uv[corner].u;
+    out->v = tex->uv[corner].v;
+    out->layer = tex->tex_page;
+    out->shade = vertex->light_base;
+}
+
+static void M_ReleaseRoomMeshes(void)
+{
+    Memory_FreePointer(&m_RoomMeshes.ranges);
+    Memory_FreePointer(&m_RoomMeshes.anim_vertices);
+    Memory_FreePointer(&m_RoomMeshes.anim_faces);
+    m_RoomMeshes.anim_first_vertex = 0;
+    m_RoomMeshes.anim_vertex_count = 0;
+    m_RoomMeshes.anim_face_count = 0;
+    m_RoomMeshes.is_anim_dirty = false;
+    m_RoomMeshes.is_loaded = false;
+}
+
+static void M_UpdateAnimatedRoomMeshes(void)
+{
+    for (int32_t i = 0; i < m_RoomMeshes.anim_face_count; i++) {
+        const ANIMATED_FACE *const face = &m_RoomMeshes.anim_faces[i];
+        const OBJECT_TEXTURE *const tex =
+            Output_GetObjectTexture(face->texture_idx);
+        GFX_3D_MESH_VERTEX *const vertices =
+            &m_RoomMeshes.anim_vertices[face->first_vertex];
+        for (int32_t j = 0; j < face->vertex_count; j++) {
+            vertices[j].u = tex->uv[j].u;
+            vertices[j].v = tex->uv[j].v;
+            vertices[j].layer = tex->tex_page;
+        }
+    }
+
+    S_Output_UpdateRoomMeshVertices(
+        m_RoomMeshes.anim_first_vertex, m_RoomMeshes.anim_vertices,
+        m_RoomMeshes.anim_vertex_count);
+    m_RoomMeshes.is_anim_dirty = false;
+}
+
+static bool M_DrawRoomMesh(const ROOM *const room)
+{
+    // Effects that move or relight vertices every frame stay on the CPU.
+    if (!m_RoomMeshes.is_loaded || m_IsWibbleEffect || m_IsWaterEffect
+        || (room->flags & RF_DYNAMIC_LIT)) {
+        return false;
+    }
+
+    if (m_RoomMeshes.is_anim_dirty && m_RoomMeshes.anim_face_count > 0) {
+        M_UpdateAnimatedRoomMeshes();
+    }
+
+    const ROOM_MESH_RANGE *const range =
+        &m_RoomMeshes.ranges[room - Room_Get(0)];
+    return S_Output_DrawRoomMesh(range->first_index, range->index_count);
+}
+
 bool Output_Init(void)
 {
     M_CalcWibbleTable();
@@ -506,6 +701,7 @@ bool Output_Init(void)
 
 void Output_Shutdown(void)
 {
+    M_ReleaseRoomMeshes();
     S_Output_Shutdown();
     Memory_FreePointer(&m_BackdropImagePath);
 }
@@ -534,6 +730,128 @@ void Output_DownloadTextures(int page_count)
     S_Output_DownloadTextures(page_count);
 }
 
+void Output_DownloadRoomMeshes(void)
+{
+    M_ReleaseRoomMeshes();
+
+    const int32_t room_count = Room_GetCount();
+    bool *is_animated = M_GetAnimatedTextures();
+
+    int32_t vertex_count = 0;
+    int32_t anim_vertex_count = 0;
+    int32_t anim_face_count = 0;
+    int32_t index_count = 0;
+    for (int32_t i = 0; i < room_count; i++) {
+        const ROOM_MESH *const mesh = &Room_Get(i)->mesh;
+        for (int32_t j = 0; j < mesh->num_face4s; j++) {
+            if (is_animated[mesh->face4s[j].texture_idx]) {
+                anim_vertex_count += 4;
+                anim_face_count++;
+            } else {
+                vertex_count += 4;
+            }
+        }
+        for (int32_t j = 0; j < mesh->num_face3s; j++) {
+            if (is_animated[mesh->face3s[j].texture_idx]) {
+                anim_vertex_count += 3;
+                anim_face_count++;
+            } else {
+                vertex_count += 3;
+            }
+        }
+        index_count += mesh->num_face4s * 6 + mesh->num_face3s * 3;
+    }
+
+    if (index_count == 0) {
+        Memory_FreePointer(&is_animated);
+        return;
+    }
+
+    GFX_3D_MESH_VERTEX *vertices = Memory_Alloc(
+        sizeof(GFX_3D_MESH_VERTEX) * (vertex_count + anim_vertex_count));
+    uint32_t *indices = Memory_Alloc(sizeof(uint32_t) * index_count);
+    m_RoomMeshes.ranges = Memory_Alloc(sizeof(ROOM_MESH_RANGE) * room_count);
+    if (anim_face_count > 0) {
+        m_RoomMeshes.anim_faces =
+            Memory_Alloc(sizeof(ANIMATED_FACE) * anim_face_count);
+        m_RoomMeshes.anim_vertices =
+            Memory_Alloc(sizeof(GFX_3D_MESH_VERTEX) * anim_vertex_count);
+    }
+    m_RoomMeshes.anim_first_vertex = vertex_count;
+    m_RoomMeshes.anim_vertex_count = anim_vertex_count;
+
+    int32_t static_pos = 0;
+    int32_t anim_pos = vertex_count;
+    int32_t index_pos = 0;
+    for (int32_t i = 0; i < room_count; i++) {
+        const ROOM_MESH *const mesh = &Room_Get(i)->mesh;
+        m_RoomMeshes.ranges[i].first_index = index_pos;
+
+        for (int32_t j = 0; j < mesh->num_face4s + mesh->num_face3s; j++) {
+            const bool is_quad = j < mesh->num_face4s;
+            const uint16_t *const face_vertices = is_quad
+                ? mesh->face4s[j].vertices
+                : mesh->face3s[j - mesh->num_face4s].vertices;
+            const uint16_t texture_idx = is_quad
+                ? mesh->face4s[j].texture_idx
+                : mesh->face3s[j - mesh->num_face4s].texture_idx;
+            const int32_t face_vertex_count = is_quad ? 4 : 3;
+
+            int32_t first;
+            if (is_animated[texture_idx]) {
+                first = anim_pos;
+                anim_pos += face_vertex_count;
+                m_RoomMeshes.anim_faces[m_RoomMeshes.anim_face_count++] =
+                    (ANIMATED_FACE) {
+                        .texture_idx = texture_idx,
+                        .vertex_count = face_vertex_count,
+                        .first_vertex = first - vertex_count,
+                    };
+            } else {
+                first = static_pos;
+                static_pos += face_vertex_count;
+            }
+
+            const OBJECT_TEXTURE *const tex =
+                Output_GetObjectTexture(texture_idx);
+            for (int32_t k = 0; k < face_vertex_count; k++) {
+                M_FillRoomMeshVertex(
+                    &vertices[first + k], &mesh->vertices[face_vertices[k]],
+                    tex, k);
+            }
+
+            // same split as the software clipper: 0-1-2 and 2-3-0
+            indices[index_pos++] = first;
+            indices[index_pos++] = first + 1;
+            indices[index_pos++] = first + 2;
+            if (is_quad) {
+                indices[index_pos++] = first + 2;
+                indices[index_pos++] = first + 3;
+                indices[index_pos++] = first;
+            }
+        }
+
+        m_RoomMeshes.ranges[i].index_count =
+            index_pos - m_RoomMeshes.ranges[i].first_index;
+    }
+
+    if (anim_vertex_count > 0) {
+        memcpy(
+            m_RoomMeshes.anim_vertices, &vertices[vertex_count],
+            sizeof(GFX_3D_MESH_VERTEX) * anim_vertex_count);
+    }
+
+    m_RoomMeshes.is_loaded = S_Output_DownloadRoomMeshes(
+        vertices, vertex_count + anim_vertex_count, indices, index_count);
+    if (!m_RoomMeshes.is_loaded) {
+        M_ReleaseRoomMeshes();
+    }
+
+    Memory_FreePointer(&vertices);
+    Memory_FreePointer(&indices);
+    Memory_FreePointer(&is_animated);
+}
+
 void Output_DrawBlack(void)
 {
     Output_DrawBlackRectangle(255);
@@ -640,8 +958,18 @@ void Output_DrawSkybox(const OBJECT_MESH *const mesh)
     S_Output_EnableDepthTest();
 }
 
-void Output_DrawRoom(const ROOM_MESH *const mesh)
+void Output_DrawRoom(const ROOM *const room)
 {
+    const ROOM_MESH *const mesh = &room->mesh;
+    if (M_DrawRoomMesh(room)) {
+        // sprites are still drawn on the CPU, from their own vertices only
+        for (int32_t i = 0; i < mesh->num_sprites; i++) {
+            M_CalcRoomVertexBatch(mesh, mesh->sprites[i].vertex, 1);
+        }
+        M_DrawRoomSprites(mesh);
+        return;
+    }
+
     M_CalcRoomVertices(mesh);
 
     if (m_IsWibbleEffect) {
@@ -1119,6 +1447,7 @@ void Output_AnimateTextures(const int32_t num_frames)
     while (m_AnimatedTexturesOffset > 5) {
         Output_CycleAnimatedTextures();
         m_AnimatedTexturesOffset -= 5;
+        m_RoomMeshes.is_anim_dirty = true;
     }
 }
 
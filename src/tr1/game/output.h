@@ -14,6 +14,7 @@ void Output_ReserveVertexBuffer(size_t size);
 void Output_SetWindowSize(int width, int height);
 void Output_ApplyRenderSettings(void);
 void Output_DownloadTextures(int page_count);
+void Output_DownloadRoomMeshes(void);
 
 int32_t Output_GetNearZ(void);
 int32_t Output_GetFarZ(void);
@@ -37,7 +38,7 @@ void Output_SetSkyboxEnabled(bool enabled);
 bool Output_IsSkyboxEnabled(void);
 void Output_DrawSkybox(const OBJECT_MESH *mesh);
 
-void Output_DrawRoom(const ROOM_MESH *mesh);
+void Output_DrawRoom(const ROOM *room);
 void Output_DrawRoomPortals(const ROOM *room);
 void Output_DrawRoomTriggers(const ROOM *room);
 void Output_DrawShadow(int16_t size, const BOUNDS_16 *bounds, const ITEM *item);
@@ -19,12 +19,32 @@
 #include <libtrx/game/game_buf.h>
 #include <libtrx/utils.h>
 
+#include <string.h>
+
+#define M_SECTOR_CACHE_SIZE 256
+
+// Pit and sky portals only change with flipmaps and level loads. Rooms are
+// aligned to the sector grid, so the world cell together with the starting
+// sector decides which sectors the portals lead to.
+typedef struct {
+    const SECTOR *sector;
+    int32_t x_cell;
+    int32_t z_cell;
+    bool flip_status;
+    SECTOR *pit_sector;
+    SECTOR *sky_sector;
+} M_SECTOR_CACHE_ENTRY;
+
+static M_SECTOR_CACHE_ENTRY m_SectorCache[M_SECTOR_CACHE_SIZE] = {};
+
 static void M_TriggerMusicTrack(int16_t track, const TRIGGER *const trigger);
 
 static int16_t M_GetFloorTiltHeight(
     const SECTOR *sector, const int32_t x, const int32_t z);
 static int16_t M_GetCeilingTiltHeight(
     const SECTOR *sector, const int32_t x, const int32_t z);
+static const M_SECTOR_CACHE_ENTRY *M_GetSectorPortals(
+    const SECTOR *sector, int32_t x, int32_t z);
 static SECTOR *M_GetSkySector(const SECTOR *sector, int32_t x, int32_t z);
 static bool M_TestLava(const ITEM *const item);
 
@@ -162,26 +182,63 @@ void Room_GetNewRoom(int32_t x, int32_t y, int32_t z, int16_t room_num)
     Room_MarkToBeDrawn(room_num);
 }
 
+static const M_SECTOR_CACHE_ENTRY *M_GetSectorPortals(
+    const SECTOR *const sector, const int32_t x, const int32_t z)
+{
+    const int32_t x_cell = x >> WALL_SHIFT;
+    const int32_t z_cell = z >> WALL_SHIFT;
+    const bool flip_status = Room_GetFlipStatus();
+    const uint32_t hash = ((uintptr_t)sector / sizeof(SECTOR))
+        ^ (x_cell * 0x9E3779B1u) ^ (z_cell * 0x85EBCA77u);
+    M_SECTOR_CACHE_ENTRY *const entry =
+        &m_SectorCache[(hash ^ (hash >> 16)) % M_SECTOR_CACHE_SIZE];
+    if (entry->sector == sector && entry->x_cell == x_cell
+        && entry->z_cell == z_cell && entry->flip_status == flip_status) {
+        return entry;
+    }
+
+    const SECTOR *pit_sector = sector;
+    while (pit_sector->portal_room.pit != NO_ROOM) {
+        const ROOM *const room = Room_Get(pit_sector->portal_room.pit);
+        pit_sector = Room_GetWorldSector(room, x, z);
+    }
+
+    const SECTOR *sky_sector = sector;
+    while (sky_sector->portal_room.sky != NO_ROOM) {
+        const ROOM *const room = Room_Get(sky_sector->portal_room.sky);
+        sky_sector = Room_GetWorldSector(room, x, z);
+    }
+
+    entry->sector = sector;
+    entry->x_cell = x_cell;
+    entry->z_cell = z_cell;
+    entry->flip_status = flip_status;
+    entry->pit_sector = (SECTOR *)pit_sector;
+    entry->sky_sector = (SECTOR *)sky_sector;
+    return entry;
+}
+
+void Room_ResetSectorCache(void)
+{
+    memset(m_SectorCache, 0, sizeof(m_SectorCache));
+}
+
 SECTOR *Room_GetPitSector(
     const SECTOR *sector, const int32_t x, const int32_t z)
 {
-    while (sector->portal_room.pit != NO_ROOM) {
-        const ROOM *const room = Room_Get(sector->portal_room.pit);
-        sector = Room_GetWorldSector(room, x, z);
+    if (sector->portal_room.pit == NO_ROOM) {
+        return (SECTOR *)sector;
     }
-
-    return (SECTOR *)sector;
+    return M_GetSectorPortals(sector, x, z)->pit_sector;
 }
 
 static SECTOR *M_GetSkySector(
     const SECTOR *sector, const int32_t x, const int32_t z)
 {
-    while (sector->portal_room.sky != NO_ROOM) {
-        const ROOM *const room = Room_Get(sector->portal_room.sky);
-        sector = Room_GetWorldSector(room, x, z);
+    if (sector->portal_room.sky == NO_ROOM) {
+        return (SECTOR *)sector;
     }
-
-    return (SECTOR *)sector;
+    return M_GetSectorPortals(sector, x, z)->sky_sector;
 }
 
 SECTOR *Room_GetSector(int32_t x, int32_t y, int32_t z, int16_t *room_num)
@@ -303,6 +360,26 @@ int16_t Room_GetHeight(const SECTOR *sector, int32_t x, int32_t y, int32_t z)
     return height;
 }
 
+void Room_GetHeights(ROOM_HEIGHT_QUERY *const queries, const int32_t count)
+{
+    int16_t room_num = NO_ROOM;
+    for (int32_t i = 0; i < count; i++) {
+        ROOM_HEIGHT_QUERY *const query = &queries[i];
+        if (query->room_num == NO_ROOM) {
+            query->room_num = room_num;
+        }
+
+        const int32_t x = query->x;
+        const int32_t y = query->y;
+        const int32_t z = query->z;
+        query->sector = Room_GetSector(x, y, z, &query->room_num);
+        query->floor = Room_GetHeight(query->sector, x, y, z);
+        query->height_type = g_HeightType;
+        query->ceiling = Room_GetCeiling(query->sector, x, y, z);
+        room_num = query->room_num;
+    }
+}
+
 static int16_t M_GetFloorTiltHeight(
     const SECTOR *sector, const int32_t x, const int32_t z)
 {
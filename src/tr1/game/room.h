@@ -7,6 +7,20 @@
 
 #include <stdint.h>
 
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t z;
+    // The room to start from, or NO_ROOM to continue from the room found by
+    // the previous query. Receives the room that contains the position.
+    int16_t room_num;
+
+    SECTOR *sector;
+    int16_t floor;
+    int16_t ceiling;
+    int32_t height_type;
+} ROOM_HEIGHT_QUERY;
+
 int16_t Room_GetTiltType(const SECTOR *sector, int32_t x, int32_t y, int32_t z);
 int32_t Room_FindGridShift(int32_t src, int32_t dst);
 void Room_GetNewRoom(int32_t x, int32_t y, int32_t z, int16_t room_num);
@@ -16,6 +30,11 @@ SECTOR *Room_GetSector(int32_t x, int32_t y, int32_t z, int16_t *room_num);
 SECTOR *Room_GetPitSector(const SECTOR *sector, int32_t x, int32_t z);
 int16_t Room_GetCeiling(const SECTOR *sector, int32_t x, int32_t y, int32_t z);
 int16_t Room_GetHeight(const SECTOR *sector, int32_t x, int32_t y, int32_t z);
+// Resolves every query in order, with the same results as calling
+// Room_GetSector, Room_GetHeight and Room_GetCeiling for each of them.
+void Room_GetHeights(ROOM_HEIGHT_QUERY *queries, int32_t count);
+// Must be called whenever the level room data is replaced.
+void Room_ResetSectorCache(void);
 int16_t Room_GetWaterHeight(int32_t x, int32_t y, int32_t z, int16_t room_num);
 
 void Room_TestTriggers(const ITEM *item);
@@ -11,6 +11,7 @@
 #include "global/types.h"
 #include "global/vars.h"
 
+#include <libtrx/benchmark.h>
 #include <libtrx/config.h>
 #include <libtrx/game/matrix.h>
 #include <libtrx/log.h>
@@ -193,6 +194,7 @@ static void M_GetBounds(int16_t room_num)
 
 void Room_DrawAllRooms(int16_t base_room, int16_t target_room)
 {
+    Benchmark_BeginZone(BENCHMARK_ZONE_DRAW_ROOMS);
     g_PhdLeft = Viewport_GetMinX();
     g_PhdTop = Viewport_GetMinY();
     g_PhdRight = Viewport_GetMaxX();
@@ -208,6 +210,7 @@ void Room_DrawAllRooms(int16_t base_room, int16_t target_room)
         Room_DrawSingleRoom(Room_DrawGetRoom(i));
     }
     Output_SetupAboveWater(false);
+    Benchmark_EndZone(BENCHMARK_ZONE_DRAW_ROOMS);
 }
 
 static void M_PrepareToDraw(int16_t room_num)
@@ -280,7 +283,7 @@ void Room_DrawSingleRoom(int16_t room_num)
     g_PhdBottom = room->bound_bottom;
 
     Output_LightRoom(room);
-    Output_DrawRoom(&room->mesh);
+    Output_DrawRoom(room);
 
     int16_t item_num = room->item_num;
     while (item_num != NO_ITEM) {
@@ -1,5 +1,6 @@
 #include "game/savegame.h"
 
+#include "game/console/common.h"
 #include "game/game.h"
 #include "game/game_flow.h"
 #include "game/game_string.h"
@@ -36,13 +37,17 @@ typedef struct {
     bool (*fill_info)(MYFILE *fp, SAVEGAME_INFO *info);
     bool (*load_from_file)(MYFILE *fp, GAME_INFO *game_info);
     bool (*load_only_resume_info)(MYFILE *fp, GAME_INFO *game_info);
-    void (*save_to_file)(MYFILE *fp, GAME_INFO *game_info);
+    // Takes ownership of fp, which may still be written to after returning.
+    bool (*save_to_file)(MYFILE *fp, GAME_INFO *game_info);
     bool (*update_death_counters)(MYFILE *fp, GAME_INFO *game_info);
+    bool (*wait_for_save)(void);
 } SAVEGAME_STRATEGY;
 
 static int32_t m_SaveSlots = 0;
 static uint16_t m_NewestSlot = 0;
 static SAVEGAME_INFO *m_SavegameInfo = nullptr;
+// The slot whose save may still be being written in the background.
+static int32_t m_PendingSaveSlot = -1;
 
 static const SAVEGAME_STRATEGY m_Strategies[] = {
     {
@@ -55,6 +60,7 @@ static const SAVEGAME_STRATEGY m_Strategies[] = {
         .load_only_resume_info = Savegame_BSON_LoadOnlyResumeInfo,
         .save_to_file = Savegame_BSON_SaveToFile,
         .update_death_counters = Savegame_BSON_UpdateDeathCounters,
+        .wait_for_save = Savegame_BSON_WaitForSave,
     },
     {
         .allow_load = true,
@@ -66,11 +72,16 @@ static const SAVEGAME_STRATEGY m_Strategies[] = {
         .load_only_resume_info = Savegame_Legacy_LoadOnlyResumeInfo,
         .save_to_file = nullptr,
         .update_death_counters = Savegame_Legacy_UpdateDeathCounters,
+        .wait_for_save = nullptr,
     },
     { 0 },
 };
 
 static void M_Clear(void);
+static void M_ClearSlot(int32_t slot_num);
+static void M_ScanSlot(int32_t slot_num);
+static void M_WaitForSaves(void);
+static void M_UpdateRequester(void);
 static void M_LoadPreprocess(void);
 static void M_LoadPostprocess(void);
 
@@ -81,15 +92,124 @@ static void M_Clear(void)
     }
 
     for (int i = 0; i < m_SaveSlots; i++) {
-        SAVEGAME_INFO *const savegame_info = &m_SavegameInfo[i];
-        savegame_info->format = 0;
-        savegame_info->counter = -1;
-        savegame_info->level_num = -1;
-        Memory_FreePointer(&savegame_info->full_path);
-        Memory_FreePointer(&savegame_info->level_title);
+        M_ClearSlot(i);
     }
 }
 
+static void M_ClearSlot(const int32_t slot_num)
+{
+    SAVEGAME_INFO *const savegame_info = &m_SavegameInfo[slot_num];
+    savegame_info->format = 0;
+    savegame_info->counter = -1;
+    savegame_info->level_num = -1;
+    Memory_FreePointer(&savegame_info->full_path);
+    Memory_FreePointer(&savegame_info->level_title);
+}
+
+static void M_ScanSlot(const int32_t slot_num)
+{
+    SAVEGAME_INFO *const savegame_info = &m_SavegameInfo[slot_num];
+    const SAVEGAME_STRATEGY *strategy = &m_Strategies[0];
+    while (strategy->format) {
+        if (!savegame_info->format && strategy->allow_load) {
+            char *filename = strategy->get_save_filename(slot_num);
+
+            char *full_path =
+                Memory_Alloc(strlen(SAVES_DIR) + strlen(filename) + 2);
+            sprintf(full_path, "%s/%s", SAVES_DIR, filename);
+
+            MYFILE *fp = nullptr;
+            if (!fp) {
+                fp = File_Open(full_path, FILE_OPEN_READ);
+            }
+            if (!fp) {
+                fp = File_Open(filename, FILE_OPEN_READ);
+            }
+
+            if (fp) {
+                if (strategy->fill_info(fp, savegame_info)) {
+                    savegame_info->format = strategy->format;
+                    Memory_FreePointer(&savegame_info->full_path);
+                    savegame_info->full_path = Memory_DupStr(File_GetPath(fp));
+                }
+                File_Close(fp);
+            }
+
+            Memory_FreePointer(&filename);
+            Memory_FreePointer(&full_path);
+        }
+        strategy++;
+    }
+}
+
+static void M_WaitForSaves(void)
+{
+    bool result = true;
+    const SAVEGAME_STRATEGY *strategy = &m_Strategies[0];
+    while (strategy->format) {
+        if (strategy->wait_for_save != nullptr && !strategy->wait_for_save()) {
+            result = false;
+        }
+        strategy++;
+    }
+
+    const int32_t slot_num = m_PendingSaveSlot;
+    m_PendingSaveSlot = -1;
+    if (result || slot_num == -1) {
+        return;
+    }
+
+    // The slot details were filled in before the write, so read back
+    // whatever actually ended up on disk.
+    LOG_ERROR("Failed to write savegame to slot %d", slot_num);
+    M_ClearSlot(slot_num);
+    M_ScanSlot(slot_num);
+    M_UpdateRequester();
+    Console_Log(GS(OSD_SAVE_GAME_FAIL), slot_num + 1);
+}
+
+static void M_UpdateRequester(void)
+{
+    g_SaveCounter = 0;
+    g_SavedGamesCount = 0;
+    for (int i = 0; i < m_SaveSlots; i++) {
+        const SAVEGAME_INFO *const savegame_info = &m_SavegameInfo[i];
+        if (savegame_info->level_title) {
+            if (savegame_info->counter > g_SaveCounter) {
+                g_SaveCounter = savegame_info->counter;
+            }
+            g_SavedGamesCount++;
+        }
+    }
+
+    REQUEST_INFO *req = &g_SavegameRequester;
+    Requester_ClearTextstrings(req);
+    Requester_Init(&g_SavegameRequester, Savegame_GetSlotCount());
+
+    for (int i = 0; i < req->max_items; i++) {
+        SAVEGAME_INFO *savegame_info = &m_SavegameInfo[i];
+
+        if (savegame_info->level_title) {
+            if (savegame_info->counter == g_SaveCounter) {
+                m_NewestSlot = i;
+            }
+            Requester_AddItem(
+                req, false, "%s %d", savegame_info->level_title,
+                savegame_info->counter);
+        } else {
+            Requester_AddItem(req, true, GS(MISC_EMPTY_SLOT_FMT), i + 1);
+        }
+    }
+
+    if (req->requested >= req->vis_lines) {
+        req->line_offset = req->requested - req->vis_lines + 1;
+    } else if (req->requested < req->line_offset) {
+        req->line_offset = req->requested;
+    }
+
+    g_SaveCounter++;
+}
+
 static void M_LoadPreprocess(void)
 {
     Savegame_InitCurrentInfo();
@@ -225,6 +345,11 @@ RESUME_INFO *Savegame_GetCurrentInfo(const GF_LEVEL *const level)
 
 void Savegame_Shutdown(void)
 {
+    // The slots are about to be freed and the console may already be gone,
+    // so a failed save is only logged.
+    m_PendingSaveSlot = -1;
+    M_WaitForSaves();
+    Savegame_BSON_Shutdown();
     M_Clear();
     Memory_FreePointer(&m_SavegameInfo);
     Memory_FreePointer(&g_GameInfo.current);
@@ -476,6 +601,7 @@ bool Savegame_Load(const int32_t slot_num)
     SAVEGAME_INFO *savegame_info = &m_SavegameInfo[slot_num];
     ASSERT(savegame_info->format != 0);
 
+    M_WaitForSaves();
     M_LoadPreprocess();
 
     bool ret = false;
@@ -505,6 +631,10 @@ bool Savegame_Save(const int32_t slot_num)
 {
     GAME_INFO *const game_info = &g_GameInfo;
     bool ret = true;
+
+    // Opening the slot truncates it, so a previous save to the same slot
+    // must be fully written first.
+    M_WaitForSaves();
     Savegame_BindSlot(slot_num);
 
     File_CreateDirectory(SAVES_DIR);
@@ -531,13 +661,29 @@ bool Savegame_Save(const int32_t slot_num)
 
             MYFILE *fp = File_Open(full_path, FILE_OPEN_WRITE);
             if (fp) {
-                strategy->save_to_file(fp, game_info);
+                // Fill in the slot details right away rather than reading
+                // them back, as the file may still be being written.
                 savegame_info->format = strategy->format;
                 Memory_FreePointer(&savegame_info->full_path);
                 savegame_info->full_path = Memory_DupStr(File_GetPath(fp));
                 savegame_info->counter = g_SaveCounter;
                 savegame_info->level_num = current_level->num;
-                File_Close(fp);
+                Memory_FreePointer(&savegame_info->level_title);
+                savegame_info->level_title =
+                    Memory_DupStr(current_level->title);
+                savegame_info->initial_version =
+                    game_info->save_initial_version;
+                savegame_info->features.restart =
+                    game_info->save_initial_version >= VERSION_LEGACY;
+                savegame_info->features.select_level =
+                    game_info->save_initial_version >= VERSION_1;
+                if (strategy->save_to_file(fp, game_info)) {
+                    m_PendingSaveSlot = slot_num;
+                } else {
+                    M_ClearSlot(slot_num);
+                    M_ScanSlot(slot_num);
+                    ret = false;
+                }
             } else {
                 ret = false;
             }
@@ -548,13 +694,7 @@ bool Savegame_Save(const int32_t slot_num)
         strategy++;
     }
 
-    if (ret) {
-        REQUEST_INFO *req = &g_SavegameRequester;
-        Requester_ChangeItem(
-            req, slot_num, false, "%s %d", current_level->title, g_SaveCounter);
-    }
-
-    Savegame_ScanSavedGames();
+    M_UpdateRequester();
 
     return ret;
 }
@@ -566,6 +706,8 @@ bool Savegame_UpdateDeathCounters(int32_t slot_num, GAME_INFO *game_info)
     SAVEGAME_INFO *savegame_info = &m_SavegameInfo[slot_num];
     ASSERT(savegame_info->format != 0);
 
+    M_WaitForSaves();
+
     bool ret = false;
     const SAVEGAME_STRATEGY *strategy = &m_Strategies[0];
     while (strategy->format) {
@@ -589,6 +731,8 @@ bool Savegame_LoadOnlyResumeInfo(int32_t slot_num, GAME_INFO *game_info)
     SAVEGAME_INFO *savegame_info = &m_SavegameInfo[slot_num];
     ASSERT(savegame_info->format != 0);
 
+    M_WaitForSaves();
+
     bool ret = false;
     const SAVEGAME_STRATEGY *strategy = &m_Strategies[0];
     while (strategy->format) {
@@ -610,80 +754,14 @@ bool Savegame_LoadOnlyResumeInfo(int32_t slot_num, GAME_INFO *game_info)
 
 void Savegame_ScanSavedGames(void)
 {
+    M_WaitForSaves();
     M_Clear();
 
-    g_SaveCounter = 0;
-    g_SavedGamesCount = 0;
-
     for (int i = 0; i < m_SaveSlots; i++) {
-        SAVEGAME_INFO *savegame_info = &m_SavegameInfo[i];
-        const SAVEGAME_STRATEGY *strategy = &m_Strategies[0];
-        while (strategy->format) {
-            if (!savegame_info->format && strategy->allow_load) {
-                char *filename = strategy->get_save_filename(i);
-
-                char *full_path =
-                    Memory_Alloc(strlen(SAVES_DIR) + strlen(filename) + 2);
-                sprintf(full_path, "%s/%s", SAVES_DIR, filename);
-
-                MYFILE *fp = nullptr;
-                if (!fp) {
-                    fp = File_Open(full_path, FILE_OPEN_READ);
-                }
-                if (!fp) {
-                    fp = File_Open(filename, FILE_OPEN_READ);
-                }
-
-                if (fp) {
-                    if (strategy->fill_info(fp, savegame_info)) {
-                        savegame_info->format = strategy->format;
-                        Memory_FreePointer(&savegame_info->full_path);
-                        savegame_info->full_path =
-                            Memory_DupStr(File_GetPath(fp));
-                    }
-                    File_Close(fp);
-                }
-
-                Memory_FreePointer(&filename);
-                Memory_FreePointer(&full_path);
-            }
-            strategy++;
-        }
-
-        if (savegame_info->level_title) {
-            if (savegame_info->counter > g_SaveCounter) {
-                g_SaveCounter = savegame_info->counter;
-            }
-            g_SavedGamesCount++;
-        }
-    }
-
-    REQUEST_INFO *req = &g_SavegameRequester;
-    Requester_ClearTextstrings(req);
-    Requester_Init(&g_SavegameRequester, Savegame_GetSlotCount());
-
-    for (int i = 0; i < req->max_items; i++) {
-        SAVEGAME_INFO *savegame_info = &m_SavegameInfo[i];
-
-        if (savegame_info->level_title) {
-            if (savegame_info->counter == g_SaveCounter) {
-                m_NewestSlot = i;
-            }
-            Requester_AddItem(
-                req, false, "%s %d", savegame_info->level_title,
-                savegame_info->counter);
-        } else {
-            Requester_AddItem(req, true, GS(MISC_EMPTY_SLOT_FMT), i + 1);
-        }
-    }
-
-    if (req->requested >= req->vis_lines) {
-        req->line_offset = req->requested - req->vis_lines + 1;
-    } else if (req->requested < req->line_offset) {
-        req->line_offset = req->requested;
+        M_ScanSlot(i);
     }
 
-    g_SaveCounter++;
+    M_UpdateRequester();
 }
 
 void Savegame_ScanAvailableLevels(REQUEST_INFO *req)
@@ -11,7 +11,6 @@
 #include "game/lot.h"
 #include "game/music.h"
 #include "game/room.h"
-#include "game/shell.h"
 #include "game/stats.h"
 #include "global/const.h"
 #include "global/vars.h"
@@ -24,12 +23,17 @@
 #include <libtrx/memory.h>
 #include <libtrx/utils.h>
 
+#include <SDL2/SDL_error.h>
+#include <SDL2/SDL_thread.h>
 #include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 #include <zconf.h>
 #include <zlib.h>
 
 #define SAVEGAME_BSON_MAGIC MKTAG('T', '1', 'M', 'B')
+#define SAVEGAME_BSON_INFO_MAGIC MKTAG('T', '1', 'M', 'I')
+#define SAVEGAME_BSON_CHUNK_SIZE (16 * 1024)
 
 #pragma pack(push, 1)
 typedef struct {
@@ -39,6 +43,16 @@ typedef struct {
     int32_t compressed_size;
     int32_t uncompressed_size;
 } SAVEGAME_BSON_HEADER;
+
+// Uncompressed copy of the details shown in the passport, stored right after
+// the compressed data so that older builds still read the file as before.
+// Followed by the level title, without a terminator.
+typedef struct {
+    uint32_t magic;
+    int32_t save_counter;
+    int32_t level_num;
+    uint16_t title_size;
+} SAVEGAME_BSON_INFO;
 #pragma pack(pop)
 
 typedef struct {
@@ -46,7 +60,40 @@ typedef struct {
     int16_t id_map[NUM_EFFECTS];
 } SAVEGAME_BSON_FX_ORDER;
 
-static void M_SaveRaw(MYFILE *fp, JSON_VALUE *root, int32_t version);
+typedef struct {
+    MYFILE *fp;
+    z_stream stream;
+    Bytef buffer[SAVEGAME_BSON_CHUNK_SIZE];
+} SAVEGAME_BSON_DEFLATE_STATE;
+
+typedef struct {
+    MYFILE *fp;
+    JSON_VALUE *root;
+    int32_t version;
+    int16_t initial_version;
+    bool result;
+} SAVEGAME_BSON_PENDING_SAVE;
+
+// Savegame trees are built from thousands of small nodes that are all thrown
+// away together after writing, so they are allocated from an arena.
+static MEMORY_ARENA_ALLOCATOR m_Arena = {
+    .default_chunk_size = 64 * 1024,
+};
+
+// The most recent savegame tree, which is written out on a background thread
+// when async saves are enabled so that saving doesn't stall the game loop.
+static SDL_Thread *m_SaveThread = nullptr;
+static SAVEGAME_BSON_PENDING_SAVE m_PendingSave = {};
+
+static bool M_Deflate(SAVEGAME_BSON_DEFLATE_STATE *state, int flush);
+static bool M_DeflateBSON(const void *data, size_t size, void *user_data);
+static bool M_SaveRaw(
+    MYFILE *fp, JSON_VALUE *root, int32_t version, int16_t initial_version);
+static int M_SaveThread(void *arg);
+static bool M_FinishPendingSave(void);
+static void M_SaveInfo(MYFILE *fp, JSON_VALUE *root);
+static bool M_LoadInfo(
+    MYFILE *fp, const SAVEGAME_BSON_HEADER *header, SAVEGAME_INFO *info);
 static JSON_VALUE *M_ParseFromBuffer(
     const char *buffer, size_t buffer_size, int32_t *version_out);
 static JSON_VALUE *M_ParseFromFile(MYFILE *fp, int32_t *version_out);
@@ -87,34 +134,143 @@ static void M_GetFXOrder(SAVEGAME_BSON_FX_ORDER *order);
 static bool M_IsValidItemObject(
     GAME_OBJECT_ID saved_obj_id, GAME_OBJECT_ID current_obj_id);
 
-static void M_SaveRaw(MYFILE *fp, JSON_VALUE *root, int32_t version)
+static bool M_Deflate(SAVEGAME_BSON_DEFLATE_STATE *const state, const int flush)
 {
-    size_t uncompressed_size;
-    char *uncompressed = BSON_Write(root, &uncompressed_size);
-
-    uLongf compressed_size = compressBound(uncompressed_size);
-    char *compressed = Memory_Alloc(compressed_size);
-    if (compress(
-            (Bytef *)compressed, &compressed_size, (const Bytef *)uncompressed,
-            (uLongf)uncompressed_size)
-        != Z_OK) {
-        Shell_ExitSystem("Failed to compress savegame data");
-    }
+    z_stream *const stream = &state->stream;
+    do {
+        stream->next_out = state->buffer;
+        stream->avail_out = SAVEGAME_BSON_CHUNK_SIZE;
+        if (deflate(stream, flush) == Z_STREAM_ERROR) {
+            return false;
+        }
+        File_WriteData(
+            state->fp, state->buffer,
+            SAVEGAME_BSON_CHUNK_SIZE - stream->avail_out);
+    } while (stream->avail_out == 0);
+    return true;
+}
 
-    Memory_FreePointer(&uncompressed);
+static bool M_DeflateBSON(
+    const void *const data, const size_t size, void *const user_data)
+{
+    SAVEGAME_BSON_DEFLATE_STATE *const state = user_data;
+    state->stream.next_in = (Bytef *)data;
+    state->stream.avail_in = size;
+    return M_Deflate(state, Z_NO_FLUSH);
+}
 
+static bool M_SaveRaw(
+    MYFILE *const fp, JSON_VALUE *const root, const int32_t version,
+    const int16_t initial_version)
+{
+    // The BSON data is compressed as it is produced and written straight to
+    // the file. The header is filled in once the sizes are known.
     SAVEGAME_BSON_HEADER header = {
         .magic = SAVEGAME_BSON_MAGIC,
-        .initial_version = g_GameInfo.save_initial_version,
+        .initial_version = initial_version,
         .version = version,
-        .compressed_size = compressed_size,
-        .uncompressed_size = uncompressed_size,
     };
+    const size_t header_pos = File_Pos(fp);
+    File_WriteData(fp, &header, sizeof(header));
 
+    SAVEGAME_BSON_DEFLATE_STATE *state =
+        Memory_Alloc(sizeof(SAVEGAME_BSON_DEFLATE_STATE));
+    state->fp = fp;
+    if (deflateInit(&state->stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
+        LOG_ERROR("Failed to initialise savegame compression");
+        Memory_FreePointer(&state);
+        return false;
+    }
+
+    bool result = BSON_WriteStream(root, M_DeflateBSON, state);
+    if (result) {
+        state->stream.next_in = nullptr;
+        state->stream.avail_in = 0;
+        result = M_Deflate(state, Z_FINISH);
+    }
+    header.compressed_size = state->stream.total_out;
+    header.uncompressed_size = state->stream.total_in;
+    deflateEnd(&state->stream);
+    Memory_FreePointer(&state);
+
+    if (!result) {
+        LOG_ERROR("Failed to compress savegame data");
+        return false;
+    }
+
+    File_Seek(fp, header_pos, FILE_SEEK_SET);
     File_WriteData(fp, &header, sizeof(header));
-    File_WriteData(fp, compressed, compressed_size);
+    File_Seek(
+        fp, header_pos + sizeof(header) + header.compressed_size,
+        FILE_SEEK_SET);
+    M_SaveInfo(fp, root);
+    return true;
+}
+
+static int M_SaveThread(void *const arg)
+{
+    SAVEGAME_BSON_PENDING_SAVE *const save = arg;
+    save->result =
+        M_SaveRaw(save->fp, save->root, save->version, save->initial_version);
+    File_Close(save->fp);
+    return 0;
+}
+
+static bool M_FinishPendingSave(void)
+{
+    const bool result = m_PendingSave.result;
+    JSON_ValueFree(m_PendingSave.root);
+    m_PendingSave.root = nullptr;
+    m_PendingSave.fp = nullptr;
+    Memory_ArenaReset(&m_Arena);
+    return result;
+}
+
+static void M_SaveInfo(MYFILE *const fp, JSON_VALUE *const root)
+{
+    const JSON_OBJECT *const root_obj = JSON_ValueAsObject(root);
+    const char *const level_title =
+        JSON_ObjectGetString(root_obj, "level_title", "");
+    const SAVEGAME_BSON_INFO info = {
+        .magic = SAVEGAME_BSON_INFO_MAGIC,
+        .save_counter = JSON_ObjectGetInt(root_obj, "save_counter", -1),
+        .level_num = JSON_ObjectGetInt(root_obj, "level_num", -1),
+        .title_size = MIN(strlen(level_title), UINT16_MAX),
+    };
+    File_WriteData(fp, &info, sizeof(info));
+    File_WriteData(fp, level_title, info.title_size);
+}
+
+static bool M_LoadInfo(
+    MYFILE *const fp, const SAVEGAME_BSON_HEADER *const header,
+    SAVEGAME_INFO *const info)
+{
+    // Savegames from older builds don't have the info block, and need to be
+    // parsed in full instead.
+    const size_t file_size = File_Size(fp);
+    const size_t offset =
+        sizeof(SAVEGAME_BSON_HEADER) + (size_t)header->compressed_size;
+    if (header->magic != SAVEGAME_BSON_MAGIC || header->compressed_size < 0
+        || offset + sizeof(SAVEGAME_BSON_INFO) > file_size) {
+        return false;
+    }
 
-    Memory_FreePointer(&compressed);
+    SAVEGAME_BSON_INFO saved_info;
+    File_Seek(fp, offset, FILE_SEEK_SET);
+    File_ReadData(fp, &saved_info, sizeof(saved_info));
+    if (saved_info.magic != SAVEGAME_BSON_INFO_MAGIC
+        || offset + sizeof(saved_info) + saved_info.title_size > file_size) {
+        return false;
+    }
+
+    info->counter = saved_info.save_counter;
+    info->level_num = saved_info.level_num;
+    if (saved_info.title_size > 0) {
+        char *const level_title = Memory_Alloc(saved_info.title_size + 1);
+        File_ReadData(fp, level_title, saved_info.title_size);
+        info->level_title = level_title;
+    }
+    return true;
 }
 
 static void M_GetFXOrder(SAVEGAME_BSON_FX_ORDER *order)
@@ -1299,23 +1455,28 @@ char *Savegame_BSON_GetSaveFileName(int32_t slot)
 bool Savegame_BSON_FillInfo(MYFILE *fp, SAVEGAME_INFO *info)
 {
     bool ret = false;
-    JSON_VALUE *root = M_ParseFromFile(fp, nullptr);
-    JSON_OBJECT *root_obj = JSON_ValueAsObject(root);
-    if (root_obj) {
-        info->counter = JSON_ObjectGetInt(root_obj, "save_counter", -1);
-        info->level_num = JSON_ObjectGetInt(root_obj, "level_num", -1);
-        const char *level_title =
-            JSON_ObjectGetString(root_obj, "level_title", nullptr);
-        if (level_title) {
-            info->level_title = Memory_DupStr(level_title);
-        }
+    SAVEGAME_BSON_HEADER header = {};
+    File_Seek(fp, 0, FILE_SEEK_SET);
+    File_ReadData(fp, &header, sizeof(SAVEGAME_BSON_HEADER));
+
+    if (M_LoadInfo(fp, &header, info)) {
         ret = info->level_num != -1;
+    } else {
+        JSON_VALUE *root = M_ParseFromFile(fp, nullptr);
+        JSON_OBJECT *root_obj = JSON_ValueAsObject(root);
+        if (root_obj) {
+            info->counter = JSON_ObjectGetInt(root_obj, "save_counter", -1);
+            info->level_num = JSON_ObjectGetInt(root_obj, "level_num", -1);
+            const char *level_title =
+                JSON_ObjectGetString(root_obj, "level_title", nullptr);
+            if (level_title) {
+                info->level_title = Memory_DupStr(level_title);
+            }
+            ret = info->level_num != -1;
+        }
+        JSON_ValueFree(root);
     }
-    JSON_ValueFree(root);
 
-    SAVEGAME_BSON_HEADER header;
-    File_Seek(fp, 0, FILE_SEEK_SET);
-    File_ReadData(fp, &header, sizeof(SAVEGAME_BSON_HEADER));
     info->initial_version = header.initial_version;
     info->features.restart = header.initial_version >= VERSION_LEGACY;
     info->features.select_level = header.initial_version >= VERSION_1;
@@ -1448,11 +1609,32 @@ cleanup:
     return ret;
 }
 
-void Savegame_BSON_SaveToFile(MYFILE *fp, GAME_INFO *game_info)
+bool Savegame_BSON_WaitForSave(void)
+{
+    if (m_SaveThread == nullptr) {
+        return true;
+    }
+    SDL_WaitThread(m_SaveThread, nullptr);
+    m_SaveThread = nullptr;
+    return M_FinishPendingSave();
+}
+
+void Savegame_BSON_Shutdown(void)
+{
+    ASSERT(m_SaveThread == nullptr);
+    Memory_ArenaFree(&m_Arena);
+}
+
+bool Savegame_BSON_SaveToFile(MYFILE *fp, GAME_INFO *game_info)
 {
     ASSERT(game_info != nullptr);
 
+    // The arena holding the previous tree can only be reused once it's
+    // written out, which Savegame_Save waits for.
+    ASSERT(m_SaveThread == nullptr);
+
     const GF_LEVEL *const current_level = Game_GetCurrentLevel();
+    JSON_ArenaBegin(&m_Arena);
     JSON_OBJECT *root_obj = JSON_ObjectNew();
 
     JSON_ObjectAppendString(root_obj, "level_title", current_level->title);
@@ -1473,8 +1655,28 @@ void Savegame_BSON_SaveToFile(MYFILE *fp, GAME_INFO *game_info)
         root_obj, "music_track_flags", M_DumpMusicTrackFlags());
 
     JSON_VALUE *root = JSON_ValueFromObject(root_obj);
-    M_SaveRaw(fp, root, SAVEGAME_CURRENT_VERSION);
-    JSON_ValueFree(root);
+    JSON_ArenaEnd();
+
+    // The tree is a snapshot of the game state, so the game can carry on
+    // while it's being compressed and written.
+    m_PendingSave = (SAVEGAME_BSON_PENDING_SAVE) {
+        .fp = fp,
+        .root = root,
+        .version = SAVEGAME_CURRENT_VERSION,
+        .initial_version = g_GameInfo.save_initial_version,
+    };
+
+    if (g_Config.gameplay.enable_async_saves) {
+        m_SaveThread =
+            SDL_CreateThread(M_SaveThread, "savegame", &m_PendingSave);
+        if (m_SaveThread != nullptr) {
+            return true;
+        }
+        LOG_ERROR("SDL_CreateThread(): %s", SDL_GetError());
+    }
+
+    M_SaveThread(&m_PendingSave);
+    return M_FinishPendingSave();
 }
 
 bool Savegame_BSON_UpdateDeathCounters(MYFILE *fp, GAME_INFO *game_info)
@@ -1497,8 +1699,7 @@ bool Savegame_BSON_UpdateDeathCounters(MYFILE *fp, GAME_INFO *game_info)
     JSON_ObjectAppendInt(misc_obj, "death_count", game_info->death_count);
 
     File_Seek(fp, 0, FILE_SEEK_SET);
-    M_SaveRaw(fp, root, version);
-    result = true;
+    result = M_SaveRaw(fp, root, version, g_GameInfo.save_initial_version);
 
 cleanup:
     JSON_ValueFree(root);
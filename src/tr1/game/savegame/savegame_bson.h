@@ -13,5 +13,11 @@ char *Savegame_BSON_GetSaveFileName(int32_t slot);
 bool Savegame_BSON_FillInfo(MYFILE *fp, SAVEGAME_INFO *info);
 bool Savegame_BSON_LoadFromFile(MYFILE *fp, GAME_INFO *game_info);
 bool Savegame_BSON_LoadOnlyResumeInfo(MYFILE *fp, GAME_INFO *game_info);
-void Savegame_BSON_SaveToFile(MYFILE *fp, GAME_INFO *game_info);
+// Takes ownership of fp. With async saves enabled the file is written and
+// closed on a background thread; use Savegame_BSON_WaitForSave before reading
+// it back. Returns false if a synchronous write failed.
+bool Savegame_BSON_SaveToFile(MYFILE *fp, GAME_INFO *game_info);
+// Returns false if the pending background write failed.
+bool Savegame_BSON_WaitForSave(void);
+void Savegame_BSON_Shutdown(void);
 bool Savegame_BSON_UpdateDeathCounters(MYFILE *fp, GAME_INFO *game_info);
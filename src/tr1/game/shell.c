@@ -2,6 +2,7 @@
 
 #include "game/clock.h"
 #include "game/console/common.h"
+#include "game/demo.h"
 #include "game/fmv.h"
 #include "game/game.h"
 #include "game/game_flow.h"
@@ -191,7 +192,8 @@ void Shell_Main(void)
         m_ModPaths[m_ActiveMod].game_flow_path,
         m_ModPaths[m_ActiveMod].game_strings_path);
 
-    GF_COMMAND gf_cmd = GF_DoFrontendSequence();
+    GF_COMMAND gf_cmd = Demo_Benchmark_IsActive() ? Demo_Benchmark_Run()
+                                                  : GF_DoFrontendSequence();
     bool loop_continue = !Shell_IsExiting();
     while (loop_continue) {
         LOG_INFO(
@@ -267,7 +269,9 @@ void Shell_Main(void)
         }
     }
 
-    Config_Write();
+    if (!Demo_Benchmark_IsActive()) {
+        Config_Write();
+    }
     EnumMap_Shutdown();
     GameString_Shutdown();
 }
@@ -10,6 +10,7 @@
 #include <libtrx/config.h>
 #include <libtrx/debug.h>
 #include <libtrx/log.h>
+#include <libtrx/memory.h>
 
 #include <string.h>
 
@@ -28,11 +29,14 @@
 
 static int m_TextureMap[GFX_MAX_TEXTURES] = { GFX_NO_TEXTURE };
 static int m_EnvMapTexture = GFX_NO_TEXTURE;
+static int m_TextureArray = GFX_NO_TEXTURE;
+static int32_t m_TextureArrayPages = 0;
 
 static GFX_2D_RENDERER *m_Renderer2D = nullptr;
 static GFX_3D_RENDERER *m_Renderer3D = nullptr;
 static bool m_IsTextureMode = false;
 static int32_t m_SelectedTexture = -1;
+static float m_SelectedLayer = 0.0f;
 
 static int32_t m_SurfaceWidth = 0;
 static int32_t m_SurfaceHeight = 0;
@@ -45,10 +49,12 @@ static GFX_2D_SURFACE *m_PictureSurface = nullptr;
 static GFX_2D_SURFACE *m_TextureSurfaces[GFX_MAX_TEXTURES] = { nullptr };
 
 static inline float M_GetUV(uint16_t uv);
+static bool M_IsTextureLoaded(int32_t texture_num);
 static void M_ReleaseTextures(void);
 static void M_ReleaseSurfaces(void);
 static void M_FlipPrimaryBuffer(void);
 static void M_ClearSurface(GFX_2D_SURFACE *surface);
+static void M_SetLayer(GFX_3D_VERTEX *vertices, int vertex_count);
 static void M_DrawTriangleFan(GFX_3D_VERTEX *vertices, int vertex_count);
 static void M_DrawTriangleStrip(GFX_3D_VERTEX *vertices, int vertex_count);
 static int32_t M_VisibleZClip(
@@ -64,6 +70,14 @@ static inline float M_GetUV(const uint16_t uv)
         : ((uv & 0xFF00) + 127) / 65536.0f;
 }
 
+static bool M_IsTextureLoaded(const int32_t texture_num)
+{
+    if (m_TextureArray != GFX_NO_TEXTURE) {
+        return texture_num >= 0 && texture_num < m_TextureArrayPages;
+    }
+    return m_TextureMap[texture_num] != GFX_NO_TEXTURE;
+}
+
 static void M_ReleaseTextures(void)
 {
     if (m_Renderer3D == nullptr) {
@@ -76,6 +90,11 @@ static void M_ReleaseTextures(void)
             m_TextureMap[i] = GFX_NO_TEXTURE;
         }
     }
+    if (m_TextureArray != GFX_NO_TEXTURE) {
+        GFX_3D_Renderer_UnregisterTextureArray(m_Renderer3D, m_TextureArray);
+        m_TextureArray = GFX_NO_TEXTURE;
+        m_TextureArrayPages = 0;
+    }
     if (m_EnvMapTexture != GFX_NO_TEXTURE) {
         GFX_3D_Renderer_UnregisterEnvironmentMap(m_Renderer3D, m_EnvMapTexture);
     }
@@ -118,13 +137,22 @@ static void M_ClearSurface(GFX_2D_SURFACE *surface)
     GFX_2D_Surface_Clear(surface, 0);
 }
 
+static void M_SetLayer(GFX_3D_VERTEX *const vertices, const int vertex_count)
+{
+    for (int i = 0; i < vertex_count; i++) {
+        vertices[i].layer = m_SelectedLayer;
+    }
+}
+
 static void M_DrawTriangleFan(GFX_3D_VERTEX *vertices, int vertex_count)
 {
+    M_SetLayer(vertices, vertex_count);
     GFX_3D_Renderer_RenderPrimFan(m_Renderer3D, vertices, vertex_count);
 }
 
 static void M_DrawTriangleStrip(GFX_3D_VERTEX *vertices, int vertex_count)
 {
+    M_SetLayer(vertices, vertex_count);
     GFX_3D_Renderer_RenderPrimStrip(m_Renderer3D, vertices, vertex_count);
 }
 
@@ -317,12 +345,22 @@ void S_Output_SelectTexture(const int32_t texture_num)
         return;
     }
 
-    if (m_TextureMap[texture_num] == GFX_NO_TEXTURE) {
+    if (!M_IsTextureLoaded(texture_num)) {
         LOG_ERROR("ERROR: Attempt to select unloaded texture");
         return;
     }
 
-    GFX_3D_Renderer_SelectTexture(m_Renderer3D, m_TextureMap[texture_num]);
+    if (m_TextureArray != GFX_NO_TEXTURE) {
+        // all pages live in one array texture, so switching pages only
+        // changes the layer of the next vertices and does not flush
+        if (m_SelectedTexture == -1) {
+            GFX_3D_Renderer_SelectTexture(m_Renderer3D, m_TextureArray);
+        }
+        m_SelectedLayer = texture_num;
+    } else {
+        GFX_3D_Renderer_SelectTexture(
+            m_Renderer3D, m_TextureMap[texture_num]);
+    }
 
     m_SelectedTexture = texture_num;
 }
@@ -392,7 +430,7 @@ void S_Output_DrawSprite(
         return;
     }
 
-    if (m_TextureMap[sprite->tex_page] != GFX_NO_TEXTURE) {
+    if (M_IsTextureLoaded(sprite->tex_page)) {
         S_Output_EnableTextureMode();
         S_Output_SelectTexture(sprite->tex_page);
         M_DrawTriangleFan(vertices, vertex_count);
@@ -900,7 +938,7 @@ void S_Output_DrawTexturedTriangle(
         return;
     }
 
-    if (m_TextureMap[tpage] != GFX_NO_TEXTURE) {
+    if (M_IsTextureLoaded(tpage)) {
         S_Output_EnableTextureMode();
         S_Output_SelectTexture(tpage);
         M_DrawTriangleFan(vertices, vertex_count);
@@ -963,14 +1001,14 @@ void S_Output_DrawTexturedQuad(
         Output_ApplyTint(&vertices[i].r, &vertices[i].g, &vertices[i].b);
     }
 
-    if (m_TextureMap[tpage] != GFX_NO_TEXTURE) {
+    if (M_IsTextureLoaded(tpage)) {
         S_Output_EnableTextureMode();
         S_Output_SelectTexture(tpage);
     } else {
         S_Output_DisableTextureMode();
     }
 
-    GFX_3D_Renderer_RenderPrimStrip(m_Renderer3D, vertices, vertex_count);
+    M_DrawTriangleStrip(vertices, vertex_count);
 }
 
 void S_Output_DownloadTextures(int32_t pages)
@@ -995,10 +1033,33 @@ void S_Output_DownloadTextures(int32_t pages)
         memcpy(
             output_ptr, input_ptr,
             surface->desc.width * surface->desc.height * sizeof(RGBA_8888));
+    }
+
+    if (pages > 0) {
+        const size_t page_size =
+            TEXTURE_PAGE_WIDTH * TEXTURE_PAGE_HEIGHT * sizeof(RGBA_8888);
+        char *array_data = Memory_Alloc(page_size * pages);
+        for (int32_t i = 0; i < pages; i++) {
+            memcpy(
+                array_data + page_size * i, m_TextureSurfaces[i]->buffer,
+                page_size);
+        }
+        m_TextureArray = GFX_3D_Renderer_RegisterTextureArray(
+            m_Renderer3D, array_data, TEXTURE_PAGE_WIDTH, TEXTURE_PAGE_HEIGHT,
+            pages);
+        Memory_FreePointer(&array_data);
+    }
 
-        m_TextureMap[i] = GFX_3D_Renderer_RegisterTexturePage(
-            m_Renderer3D, output_ptr, surface->desc.width,
-            surface->desc.height);
+    // Separate page textures are only needed when the array is unavailable.
+    if (m_TextureArray != GFX_NO_TEXTURE) {
+        m_TextureArrayPages = pages;
+    } else {
+        for (int32_t i = 0; i < pages; i++) {
+            GFX_2D_SURFACE *const surface = m_TextureSurfaces[i];
+            m_TextureMap[i] = GFX_3D_Renderer_RegisterTexturePage(
+                m_Renderer3D, surface->buffer, surface->desc.width,
+                surface->desc.height);
+        }
     }
 
     m_SelectedTexture = -1;
@@ -1006,6 +1067,71 @@ void S_Output_DownloadTextures(int32_t pages)
     m_EnvMapTexture = GFX_3D_Renderer_RegisterEnvironmentMap(m_Renderer3D);
 }
 
+bool S_Output_DownloadRoomMeshes(
+    const GFX_3D_MESH_VERTEX *const vertices, const int32_t vertex_count,
+    const uint32_t *const indices, const int32_t index_count)
+{
+    return GFX_3D_Renderer_UploadMeshes(
+        m_Renderer3D, vertices, vertex_count, indices, index_count);
+}
+
+void S_Output_UpdateRoomMeshVertices(
+    const int32_t first_vertex, const GFX_3D_MESH_VERTEX *const vertices,
+    const int32_t vertex_count)
+{
+    GFX_3D_Renderer_UpdateMeshVertices(
+        m_Renderer3D, first_vertex, vertices, vertex_count);
+}
+
+bool S_Output_DrawRoomMesh(const int32_t first_index, const int32_t index_count)
+{
+    if (!GFX_3D_Renderer_HasMeshes(m_Renderer3D)) {
+        return false;
+    }
+
+    float tint[3] = { 1.0f, 1.0f, 1.0f };
+    Output_ApplyTint(&tint[0], &tint[1], &tint[2]);
+    const float multiplier = g_Config.visuals.brightness / 16.0f;
+
+    const MATRIX *const mptr = g_MatrixPtr;
+    const GFX_3D_MESH_PARAMS params = {
+        .matrix = {
+            { mptr->_00, mptr->_01, mptr->_02, mptr->_03 },
+            { mptr->_10, mptr->_11, mptr->_12, mptr->_13 },
+            { mptr->_20, mptr->_21, mptr->_22, mptr->_23 },
+        },
+        .center_x = Viewport_GetCenterX(),
+        .center_y = Viewport_GetCenterY(),
+        .persp = g_PhdPersp,
+        .near_z = Output_GetNearZ(),
+        // without a skybox, the software path culls faces beyond the fog
+        .far_z = Output_IsSkyboxEnabled()
+            ? 0.0f
+            : Output_GetDrawDistMax() * (float)(1 << W2V_SHIFT),
+        .depth_base = g_FltResZBuf,
+        .depth_scale = g_FltResZ,
+        .clip = {
+            .min_x = g_PhdLeft,
+            .min_y = g_PhdTop,
+            .max_x = g_PhdRight + 1,
+            .max_y = g_PhdBottom + 1,
+        },
+        .fog_begin = Output_GetDrawDistFade() * (float)(1 << W2V_SHIFT),
+        .fog_end = Output_GetDrawDistMax() * (float)(1 << W2V_SHIFT),
+        .max_shade = MAX_LIGHTING,
+        .color = {
+            tint[0] * multiplier,
+            tint[1] * multiplier,
+            tint[2] * multiplier,
+        },
+        .snap_uvs = !g_Config.rendering.pretty_pixels
+            || g_Config.rendering.texture_filter != GFX_TF_NN,
+    };
+
+    GFX_3D_Renderer_DrawMesh(m_Renderer3D, &params, first_index, index_count);
+    return true;
+}
+
 void S_Output_ScreenBox(
     int32_t sx, int32_t sy, int32_t w, int32_t h, RGBA_8888 col_dark,
     RGBA_8888 col_light, float thickness)
@@ -28,6 +28,13 @@ void S_Output_SetWindowSize(int width, int height);
 void S_Output_ApplyRenderSettings(void);
 
 void S_Output_DownloadTextures(int32_t pages);
+bool S_Output_DownloadRoomMeshes(
+    const GFX_3D_MESH_VERTEX *vertices, int32_t vertex_count,
+    const uint32_t *indices, int32_t index_count);
+void S_Output_UpdateRoomMeshVertices(
+    int32_t first_vertex, const GFX_3D_MESH_VERTEX *vertices,
+    int32_t vertex_count);
+bool S_Output_DrawRoomMesh(int32_t first_index, int32_t index_count);
 void S_Output_SelectTexture(int32_t texture_num);
 void S_Output_DownloadBackdropSurface(const IMAGE *image);
 void S_Output_DrawBackdropSurface(void);
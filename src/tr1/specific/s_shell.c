@@ -1,6 +1,7 @@
 #include "specific/s_shell.h"
 
 #include "game/console/common.h"
+#include "game/demo.h"
 #include "game/fmv.h"
 #include "game/input.h"
 #include "game/music.h"
@@ -233,6 +234,7 @@ int main(int argc, char **argv)
 
     m_ArgCount = argc;
     m_ArgStrings = argv;
+    Demo_Benchmark_ParseArgs(argc, argv);
 
     Shell_Setup();
     Shell_Main();
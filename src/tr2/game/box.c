@@ -5,6 +5,7 @@
 #include "global/const.h"
 #include "global/vars.h"
 
+#include <libtrx/game/game_buf.h>
 #include <libtrx/utils.h>
 
 #define BOX_OVERLAP_BITS 0x3FFF
@@ -24,15 +25,95 @@
     (BOX_CLIP_LEFT | BOX_CLIP_RIGHT | BOX_CLIP_TOP | BOX_CLIP_BOTTOM) // = 15
 #define BOX_CLIP_SECONDARY 16
 
+#define M_GROUND_ZONES 4
+#define M_FLY_ZONE M_GROUND_ZONES
+#define M_ZONE_TYPES (M_GROUND_ZONES + 1)
+
+// Overlaps of every box in CSR form: the neighbours of box b are the entries
+// in [starts[b], starts[b + 1]). The neighbour heights and zones are copied
+// next to the box numbers so that the flood does not touch g_Boxes for the
+// neighbours it rejects. Zones that the level does not load stay null.
+static struct {
+    int32_t *starts;
+    int16_t *boxes;
+    int16_t *heights;
+    int16_t *zones[2][M_ZONE_TYPES];
+} m_Adjacency = {};
+
+static int32_t M_GetZoneType(const LOT_INFO *lot);
+static int16_t *M_GetZone(int32_t zone_type, bool flip_status);
+
+static int32_t M_GetZoneType(const LOT_INFO *const lot)
+{
+    return lot->fly ? M_FLY_ZONE : BOX_ZONE(lot->step);
+}
+
+static int16_t *M_GetZone(const int32_t zone_type, const bool flip_status)
+{
+    if (zone_type == M_FLY_ZONE) {
+        return g_FlyZone[flip_status];
+    }
+    return g_GroundZone[zone_type][flip_status];
+}
+
+void Box_InitialiseAdjacency(void)
+{
+    m_Adjacency.starts = GameBuf_Alloc(
+        sizeof(int32_t) * (g_BoxCount + 1), GBUF_BOX_ADJACENCY);
+
+    int32_t edge_count = 0;
+    for (int32_t i = 0; i < g_BoxCount; i++) {
+        m_Adjacency.starts[i] = edge_count;
+        int32_t index = g_Boxes[i].overlap_index & BOX_OVERLAP_BITS;
+        do {
+            edge_count++;
+        } while ((g_Overlap[index++] & BOX_END_BIT) == 0);
+    }
+    m_Adjacency.starts[g_BoxCount] = edge_count;
+
+    m_Adjacency.boxes =
+        GameBuf_Alloc(sizeof(int16_t) * edge_count, GBUF_BOX_ADJACENCY);
+    m_Adjacency.heights =
+        GameBuf_Alloc(sizeof(int16_t) * edge_count, GBUF_BOX_ADJACENCY);
+    for (int32_t i = 0; i < 2; i++) {
+        for (int32_t j = 0; j < M_ZONE_TYPES; j++) {
+            m_Adjacency.zones[i][j] = M_GetZone(j, i) == nullptr
+                ? nullptr
+                : GameBuf_Alloc(
+                      sizeof(int16_t) * edge_count, GBUF_BOX_ADJACENCY);
+        }
+    }
+
+    for (int32_t i = 0; i < g_BoxCount; i++) {
+        int32_t index = g_Boxes[i].overlap_index & BOX_OVERLAP_BITS;
+        const int32_t end = m_Adjacency.starts[i + 1];
+        for (int32_t j = m_Adjacency.starts[i]; j < end; j++) {
+            const int16_t box_num = g_Overlap[index++] & BOX_NUM_BITS;
+            m_Adjacency.boxes[j] = box_num;
+            m_Adjacency.heights[j] = g_Boxes[box_num].height;
+            for (int32_t k = 0; k < 2; k++) {
+                for (int32_t l = 0; l < M_ZONE_TYPES; l++) {
+                    const int16_t *const zone = M_GetZone(l, k);
+                    if (zone != nullptr) {
+                        m_Adjacency.zones[k][l][j] = zone[box_num];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Each creature runs its own incremental flood on purpose. Until a search
+// finishes, creatures steer by the partial exit_box chain and the blocked
+// search numbers. That state is also stored in savegames, so sharing a
+// finished distance field between creatures would change AI movement and
+// break demos and existing saves.
 int32_t Box_SearchLOT(LOT_INFO *const lot, const int32_t expansion)
 {
     const bool flip_status = Room_GetFlipStatus();
-    int16_t *zone;
-    if (lot->fly) {
-        zone = g_FlyZone[flip_status];
-    } else {
-        zone = g_GroundZone[BOX_ZONE(lot->step)][flip_status];
-    }
+    const int32_t zone_type = M_GetZoneType(lot);
+    const int16_t *const zone = M_GetZone(zone_type, flip_status);
+    const int16_t *const edge_zone = m_Adjacency.zones[flip_status][zone_type];
 
     const int16_t search_zone = zone[lot->head];
     for (int32_t i = 0; i < expansion; i++) {
@@ -42,26 +123,20 @@ int32_t Box_SearchLOT(LOT_INFO *const lot, const int32_t expansion)
         }
 
         BOX_NODE *node = &lot->node[lot->head];
-        const BOX_INFO *box = &g_Boxes[lot->head];
-
-        bool done = false;
-        int32_t index = box->overlap_index & BOX_OVERLAP_BITS;
-        while (!done) {
-            int16_t box_num = g_Overlap[index++];
-            if ((box_num & BOX_END_BIT) != 0) {
-                done = true;
-                box_num &= BOX_NUM_BITS;
-            }
+        const int16_t height = g_Boxes[lot->head].height;
 
-            if (search_zone != zone[box_num]) {
+        const int32_t end = m_Adjacency.starts[lot->head + 1];
+        for (int32_t j = m_Adjacency.starts[lot->head]; j < end; j++) {
+            if (search_zone != edge_zone[j]) {
                 continue;
             }
 
-            const int32_t change = g_Boxes[box_num].height - box->height;
+            const int32_t change = m_Adjacency.heights[j] - height;
             if (change > lot->step || change < lot->drop) {
                 continue;
             }
 
+            const int16_t box_num = m_Adjacency.boxes[j];
             BOX_NODE *const expand = &lot->node[box_num];
             if ((node->search_num & BOX_SEARCH_NUM)
                 < (expand->search_num & BOX_SEARCH_NUM)) {
@@ -199,13 +274,8 @@ int32_t Box_ValidBox(
     const ITEM *const item, const int16_t zone_num, const int16_t box_num)
 {
     const CREATURE *const creature = item->data;
-    const bool flip_status = Room_GetFlipStatus();
-    int16_t *zone;
-    if (creature->lot.fly) {
-        zone = g_FlyZone[flip_status];
-    } else {
-        zone = g_GroundZone[BOX_ZONE(creature->lot.step)][flip_status];
-    }
+    const int16_t *const zone =
+        M_GetZone(M_GetZoneType(&creature->lot), Room_GetFlipStatus());
 
     if (zone[box_num] != zone_num) {
         return false;
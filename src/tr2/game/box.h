@@ -7,6 +7,8 @@
 #define BOX_BLOCKABLE 0x8000
 #define BOX_ZONE(num) (((num) / STEP_L) - 1)
 
+// Must be called after the level boxes and overlaps are final.
+void Box_InitialiseAdjacency(void);
 int32_t Box_SearchLOT(LOT_INFO *lot, int32_t expansion);
 int32_t Box_UpdateLOT(LOT_INFO *lot, int32_t expansion);
 void Box_TargetBox(LOT_INFO *lot, int16_t box_num);
@@ -9,6 +9,7 @@
 #include "global/const.h"
 #include "global/vars.h"
 
+#include <libtrx/benchmark.h>
 #include <libtrx/debug.h>
 #include <libtrx/game/math.h>
 #include <libtrx/game/matrix.h>
@@ -52,6 +53,7 @@ static OBJECT_BOUNDS M_ConvertBounds(const int16_t *const bounds_in)
 
 void Item_Control(void)
 {
+    Benchmark_BeginZone(BENCHMARK_ZONE_ITEM_CONTROL);
     int16_t item_num = Item_GetNextActive();
     while (item_num != NO_ITEM) {
         const ITEM *const item = Item_Get(item_num);
@@ -62,6 +64,7 @@ void Item_Control(void)
         }
         item_num = next;
     }
+    Benchmark_EndZone(BENCHMARK_ZONE_ITEM_CONTROL);
 }
 
 void Item_Initialise(const int16_t item_num)
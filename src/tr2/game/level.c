@@ -2,6 +2,7 @@
 
 #include "decomp/decomp.h"
 #include "decomp/savegame.h"
+#include "game/box.h"
 #include "game/camera.h"
 #include "game/effects.h"
 #include "game/game.h"
@@ -186,6 +187,7 @@ static void M_LoadBoxes(VFILE *const file)
                     && !Object_Get(O_WORKER_3)->loaded);
 
             if (skip) {
+                g_GroundZone[j][i] = nullptr;
                 VFile_Skip(file, sizeof(int16_t) * g_BoxCount);
                 continue;
             }
@@ -335,6 +337,8 @@ static void M_CompleteSetup(void)
     BENCHMARK *const benchmark = Benchmark_Start();
 
     Inject_AllInjections();
+    Room_RebuildGrid();
+    Box_InitialiseAdjacency();
 
     Level_LoadAnimFrames(&m_LevelInfo);
     Level_LoadAnimCommands();
@@ -355,6 +359,7 @@ static void M_CompleteSetup(void)
 bool Level_Load(const GF_LEVEL *const level)
 {
     BENCHMARK *const benchmark = Benchmark_Start();
+    GF_CancelPrefetch();
 
     Audio_Sample_CloseAll();
     Audio_Sample_UnloadAll();
@@ -16,6 +16,16 @@
 #include <libtrx/log.h>
 #include <libtrx/utils.h>
 
+#define VERTEX_BATCH 8
+
+// Room vertices are transformed in batches, one vector lane per vertex.
+typedef int32_t M_VEC_I32
+    __attribute__((vector_size(VERTEX_BATCH * sizeof(int32_t))));
+typedef int64_t M_VEC_I64
+    __attribute__((vector_size(VERTEX_BATCH * sizeof(int64_t))));
+typedef double M_VEC_F64
+    __attribute__((vector_size(VERTEX_BATCH * sizeof(double))));
+
 typedef enum {
     COLOR_BLACK = 0,
     COLOR_GRAY = 1,
@@ -60,6 +70,8 @@ static int16_t m_ShadesTable[32];
 static int32_t m_RandomTable[32];
 static BACKGROUND_TYPE m_BackgroundType = BK_TRANSPARENT;
 
+static void M_CalcRoomVertexBatch(
+    const ROOM_MESH *mesh, int32_t start, int32_t count, double base_z);
 static void M_CalcRoomVertices(const ROOM_MESH *mesh, int32_t far_clip);
 static void M_CalcRoomVerticesWibble(const ROOM_MESH *mesh);
 static void M_DrawRoomSprites(const ROOM_MESH *mesh);
@@ -109,95 +121,106 @@ static void M_InsertBar(
     }
 }
 
-static void M_CalcRoomVertices(const ROOM_MESH *const mesh, int32_t far_clip)
+static void M_CalcRoomVertexBatch(
+    const ROOM_MESH *const mesh, const int32_t start, const int32_t count,
+    const double base_z)
 {
-    const double base_z = g_Config.rendering.enable_zbuffer
-        ? 0.0
-        : (g_MidSort << (W2V_SHIFT + 8));
-
-    for (int32_t i = 0; i < mesh->num_vertices; i++) {
-        PHD_VBUF *const vbuf = &g_PhdVBuf[i];
+    M_VEC_I32 x = {};
+    M_VEC_I32 y = {};
+    M_VEC_I32 z = {};
+    M_VEC_I32 shade = {};
+    for (int32_t j = 0; j < count; j++) {
+        const int32_t i = start + j;
         const ROOM_VERTEX *const vertex = &mesh->vertices[i];
-
-        // clang-format off
-        const MATRIX *const mptr = g_MatrixPtr;
-        const double xv = (
-            mptr->_00 * vertex->pos.x +
-            mptr->_01 * vertex->pos.y +
-            mptr->_02 * vertex->pos.z +
-            mptr->_03
-        );
-        const double yv = (
-            mptr->_10 * vertex->pos.x +
-            mptr->_11 * vertex->pos.y +
-            mptr->_12 * vertex->pos.z +
-            mptr->_13
-        );
-        const int32_t zv_int = (
-            mptr->_20 * vertex->pos.x +
-            mptr->_21 * vertex->pos.y +
-            mptr->_22 * vertex->pos.z +
-            mptr->_23
-        );
-        const double zv = zv_int;
-        // clang-format on
-
-        vbuf->xv = xv;
-        vbuf->yv = yv;
-        vbuf->zv = zv;
-
-        int16_t shade = vertex->light_adder;
+        x[j] = vertex->pos.x;
+        y[j] = vertex->pos.y;
+        z[j] = vertex->pos.z;
+        shade[j] = vertex->light_adder;
         if (g_IsWaterEffect) {
-            shade += m_ShadesTable
+            shade[j] += m_ShadesTable
                 [((uint8_t)g_WibbleOffset
                   + (uint8_t)
                       m_RandomTable[(mesh->num_vertices - i) % WIBBLE_SIZE])
                  % WIBBLE_SIZE];
         }
+    }
 
-        uint16_t clip_flags = 0;
-        if (zv < g_FltNearZ) {
-            clip_flags = 0xFF80;
-        } else {
-            const double persp = g_FltPersp / zv;
-            const int32_t depth = zv_int >> W2V_SHIFT;
-            vbuf->zv += base_z;
-
-            if (depth < FOG_END) {
-                if (depth > FOG_START) {
-                    shade += depth - FOG_START;
-                }
-                vbuf->rhw = persp * g_FltRhwOPersp;
-            } else {
-                // clip_flags = far_clip;
-                shade = 0x1FFF;
-                vbuf->zv = g_FltFarZ;
-                vbuf->rhw = persp * g_FltRhwOPersp;
-            }
-
-            double xs = xv * persp + g_FltWinCenterX;
-            double ys = yv * persp + g_FltWinCenterY;
-
-            if (xs < g_FltWinLeft) {
-                clip_flags |= 1;
-            } else if (xs > g_FltWinRight) {
-                clip_flags |= 2;
-            }
-
-            if (ys < g_FltWinTop) {
-                clip_flags |= 4;
-            } else if (ys > g_FltWinBottom) {
-                clip_flags |= 8;
-            }
+    // clang-format off
+    const MATRIX *const mptr = g_MatrixPtr;
+    const M_VEC_F64 xv = __builtin_convertvector(
+        mptr->_00 * x + mptr->_01 * y + mptr->_02 * z + mptr->_03,
+        M_VEC_F64);
+    const M_VEC_F64 yv = __builtin_convertvector(
+        mptr->_10 * x + mptr->_11 * y + mptr->_12 * z + mptr->_13,
+        M_VEC_F64);
+    const M_VEC_I32 zv_int =
+        mptr->_20 * x + mptr->_21 * y + mptr->_22 * z + mptr->_23;
+    const M_VEC_F64 zv = __builtin_convertvector(zv_int, M_VEC_F64);
+    // clang-format on
 
-            vbuf->xs = xs;
-            vbuf->ys = ys;
-            // clip_flags |= (~((uint8_t)(vbuf->zv / 0x155555.p0))) << 8;
+    // Unused lanes and lanes behind the near plane are projected too, but
+    // their results are never stored.
+    const M_VEC_F64 persp = (double)g_FltPersp / zv;
+    const M_VEC_F64 rhw = persp * (double)g_FltRhwOPersp;
+    const M_VEC_F64 xs = xv * persp + (double)g_FltWinCenterX;
+    const M_VEC_F64 ys = yv * persp + (double)g_FltWinCenterY;
+    const M_VEC_I32 depth = zv_int >> W2V_SHIFT;
+
+    // Comparisons set all bits of the lanes for which they hold.
+    const M_VEC_I64 is_near = (M_VEC_I64)(zv < (double)g_FltNearZ);
+    const M_VEC_I64 clip = (is_near & 0xFF80)
+        | (~is_near
+           & (((M_VEC_I64)(xs < (double)g_FltWinLeft) & 1)
+              | ((M_VEC_I64)(xs > (double)g_FltWinRight) & 2)
+              | ((M_VEC_I64)(ys < (double)g_FltWinTop) & 4)
+              | ((M_VEC_I64)(ys > (double)g_FltWinBottom) & 8)));
+
+    // Lanes in front of the near plane are either fogged or pushed to the
+    // far plane; lanes behind it keep their shade and depth.
+    const M_VEC_I32 is_near_i32 = __builtin_convertvector(is_near, M_VEC_I32);
+    const M_VEC_I32 is_far = ~is_near_i32 & (depth >= FOG_END);
+    const M_VEC_I32 is_fog = ~is_near_i32 & ~is_far;
+    const M_VEC_I32 fog = depth - FOG_START;
+    shade += is_fog & fog & (fog > 0);
+    shade = (is_far & 0x1FFF) | (~is_far & shade);
+    shade &= ~(shade < 0);
+    const M_VEC_I32 is_bright = shade > 0x1FFF;
+    shade = (is_bright & 0x1FFF) | (~is_bright & shade);
+
+    const M_VEC_I64 is_far_i64 = __builtin_convertvector(is_far, M_VEC_I64);
+    const M_VEC_I64 is_fog_i64 = __builtin_convertvector(is_fog, M_VEC_I64);
+    const M_VEC_F64 far_z = (M_VEC_F64) {} + (double)g_FltFarZ;
+    const M_VEC_F64 fog_z = zv + base_z;
+    const M_VEC_F64 zs = (M_VEC_F64)((is_far_i64 & (M_VEC_I64)far_z)
+                                     | (is_fog_i64 & (M_VEC_I64)fog_z)
+                                     | (is_near & (M_VEC_I64)zv));
+
+    for (int32_t j = 0; j < count; j++) {
+        PHD_VBUF *const vbuf = &g_PhdVBuf[start + j];
+        vbuf->xv = xv[j];
+        vbuf->yv = yv[j];
+        vbuf->zv = zs[j];
+        // Projections behind the near plane are meaningless, so those lanes
+        // are left alone rather than overwritten.
+        if (!is_near[j]) {
+            vbuf->rhw = rhw[j];
+            vbuf->xs = xs[j];
+            vbuf->ys = ys[j];
         }
+        vbuf->g = shade[j];
+        vbuf->clip = clip[j];
+    }
+}
 
-        CLAMP(shade, 0, 0x1FFF);
-        vbuf->g = shade;
-        vbuf->clip = clip_flags;
+static void M_CalcRoomVertices(const ROOM_MESH *const mesh, int32_t far_clip)
+{
+    const double base_z = g_Config.rendering.enable_zbuffer
+        ? 0.0
+        : (g_MidSort << (W2V_SHIFT + 8));
+
+    for (int32_t i = 0; i < mesh->num_vertices; i += VERTEX_BATCH) {
+        M_CalcRoomVertexBatch(
+            mesh, i, MIN(VERTEX_BATCH, mesh->num_vertices - i), base_z);
     }
 }
 
@@ -1,15 +1,26 @@
 #include "game/render/priv.h"
 
+#include "global/const.h"
 #include "global/vars.h"
 
+#include <libtrx/benchmark.h>
 #include <libtrx/config.h>
 #include <libtrx/game/game_buf.h>
 #include <libtrx/utils.h>
 
+#include <string.h>
+
+#define SORT_RADIX_BITS 8
+#define SORT_RADIX_SIZE (1 << SORT_RADIX_BITS)
+#define SORT_RADIX_PASSES (32 / SORT_RADIX_BITS)
+
 bool g_DiscardTransparent = false;
 static uint8_t *m_LabTextureUVFlag = nullptr;
+static SORT_ITEM m_SortTemp[MAX_SORT_ITEMS];
 
-static void M_QuickSort(int32_t left, int32_t right);
+static uint32_t M_GetSortKey(const SORT_ITEM *item);
+static bool M_IsSorted(const SORT_ITEM *items, int32_t count);
+static void M_RadixSort(SORT_ITEM *items, int32_t count);
 static inline void M_ClipG(
     VERTEX_INFO *buf, const VERTEX_INFO *vtx1, const VERTEX_INFO *vtx2,
     float clip);
@@ -17,35 +28,79 @@ static inline void M_ClipGUV(
     VERTEX_INFO *buf, const VERTEX_INFO *vtx1, const VERTEX_INFO *vtx2,
     float clip);
 
-static void M_QuickSort(const int32_t left, const int32_t right)
+// Polygons are drawn back to front, so the sort order is by descending depth.
+// The key flips the signed depth so that it sorts ascending as unsigned.
+static uint32_t M_GetSortKey(const SORT_ITEM *const item)
 {
-    const int32_t compare = g_SortBuffer[(left + right) / 2]._1;
-    int32_t i = left;
-    int32_t j = right;
+    return ~((uint32_t)item->_1 ^ 0x80000000);
+}
 
-    do {
-        while ((i < right) && (g_SortBuffer[i]._1 > compare)) {
-            i++;
+// Polygons with equal depth are drawn in reverse insertion order, so an
+// already sorted list has strictly increasing keys.
+static bool M_IsSorted(const SORT_ITEM *const items, const int32_t count)
+{
+    for (int32_t i = 1; i < count; i++) {
+        if (M_GetSortKey(&items[i - 1]) >= M_GetSortKey(&items[i])) {
+            return false;
         }
-        while ((left < j) && (compare > g_SortBuffer[j]._1)) {
-            j--;
+    }
+    return true;
+}
+
+// Stable LSD radix sort. The first pass reads the items backwards to put ties
+// in reverse insertion order, and passes where every key has the same digit
+// are skipped.
+static void M_RadixSort(SORT_ITEM *const items, const int32_t count)
+{
+    int32_t counts[SORT_RADIX_PASSES][SORT_RADIX_SIZE] = {};
+    for (int32_t i = 0; i < count; i++) {
+        const uint32_t key = M_GetSortKey(&items[i]);
+        for (int32_t pass = 0; pass < SORT_RADIX_PASSES; pass++) {
+            counts[pass][(key >> (pass * SORT_RADIX_BITS))
+                         & (SORT_RADIX_SIZE - 1)]++;
         }
-        if (i > j) {
-            break;
+    }
+
+    SORT_ITEM *src = items;
+    SORT_ITEM *dst = m_SortTemp;
+    bool is_reversed = true;
+    for (int32_t pass = 0; pass < SORT_RADIX_PASSES; pass++) {
+        const int32_t shift = pass * SORT_RADIX_BITS;
+        int32_t *const pass_counts = counts[pass];
+        const uint32_t digit =
+            (M_GetSortKey(&src[0]) >> shift) & (SORT_RADIX_SIZE - 1);
+        if (pass_counts[digit] == count) {
+            continue;
         }
 
-        SORT_ITEM tmp_item;
-        SWAP(g_SortBuffer[i], g_SortBuffer[j], tmp_item);
+        int32_t offset = 0;
+        for (int32_t i = 0; i < SORT_RADIX_SIZE; i++) {
+            const int32_t bucket_size = pass_counts[i];
+            pass_counts[i] = offset;
+            offset += bucket_size;
+        }
 
-        i++;
-        j--;
-    } while (i <= j);
+        for (int32_t i = 0; i < count; i++) {
+            const SORT_ITEM *const item =
+                &src[is_reversed ? count - 1 - i : i];
+            const uint32_t key = M_GetSortKey(item);
+            dst[pass_counts[(key >> shift) & (SORT_RADIX_SIZE - 1)]++] = *item;
+        }
 
-    if (left < j) {
-        M_QuickSort(left, j);
+        is_reversed = false;
+        SORT_ITEM *const tmp = src;
+        src = dst;
+        dst = tmp;
     }
-    if (i < right) {
-        M_QuickSort(i, right);
+
+    if (is_reversed) {
+        // All of the keys are equal, only the tie order needs fixing.
+        for (int32_t i = 0; i < count / 2; i++) {
+            SORT_ITEM tmp_item;
+            SWAP(items[i], items[count - 1 - i], tmp_item);
+        }
+    } else if (src != items) {
+        memcpy(items, src, sizeof(SORT_ITEM) * count);
     }
 }
 
@@ -96,12 +151,11 @@ double Render_CalculatePolyZ(
 
 void Render_SortPolyList(void)
 {
-    if (g_SurfaceCount) {
-        for (int32_t i = 0; i < g_SurfaceCount; i++) {
-            g_SortBuffer[i]._1 += i;
-        }
-        M_QuickSort(0, g_SurfaceCount - 1);
+    Benchmark_BeginZone(BENCHMARK_ZONE_SORT_POLY_LIST);
+    if (!M_IsSorted(g_SortBuffer, g_SurfaceCount)) {
+        M_RadixSort(g_SortBuffer, g_SurfaceCount);
     }
+    Benchmark_EndZone(BENCHMARK_ZONE_SORT_POLY_LIST);
 }
 
 int32_t Render_GetUVAdjustment(void)
@@ -3,19 +3,21 @@
 #include "decomp/decomp.h"
 #include "game/output.h"
 #include "game/render/priv.h"
+#include "game/render/swr_span.h"
 #include "global/vars.h"
 
 #include <libtrx/benchmark.h>
 #include <libtrx/debug.h>
 #include <libtrx/memory.h>
+#include <libtrx/thread_pool.h>
 #include <libtrx/utils.h>
 
-#define MAKE_Q_ID(g) ((g >> 16) & 0xFF)
-#define MAKE_TEX_ID(v, u) ((((v >> 16) & 0xFF) << 8) | ((u >> 16) & 0xFF))
 #define MAKE_PAL_IDX(c) (c)
 #define PIX_FMT uint8_t
 #define PIX_FMT_GL GL_UNSIGNED_BYTE
 #define ALPHA_FMT uint8_t
+#define MIN_BAND_HEIGHT 16
+#define BANDS_PER_THREAD 4
 
 typedef enum {
     POLY_GTMAP,
@@ -29,11 +31,26 @@ typedef enum {
     POLY_SPRITE,
 } POLY_TYPE;
 
+// Horizontal slice of the screen, rasterised independently of the others.
+// Each band keeps its own list of the polygons that touch it in painter's
+// order, and its own edge buffer.
+typedef struct {
+    int32_t y1;
+    int32_t y2;
+    void *x_buffer;
+    int32_t *polys;
+    int32_t poly_count;
+} M_BAND;
+
 typedef struct {
     GFX_2D_RENDERER *renderer_2d;
     GFX_2D_SURFACE *surface;
     GFX_2D_SURFACE *surface_alpha;
     GFX_COLOR palette[256];
+    THREAD_POOL *thread_pool;
+    int32_t band_count;
+    int32_t band_capacity;
+    M_BAND *bands;
 } M_PRIV;
 
 #pragma pack(push, 1)
@@ -102,10 +119,16 @@ typedef struct {
 } XBUF_XGUVP;
 #pragma pack(pop)
 
+typedef void (*M_SPAN_FUNC)(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const uint8_t *tex_page, bool is_doubled);
+
 static VERTEX_INFO m_VBuffer[32] = {};
-static void *m_XBuffer = nullptr;
-static int32_t m_XGenY1 = 0;
-static int32_t m_XGenY2 = 0;
+static _Thread_local void *m_XBuffer = nullptr;
+static _Thread_local int32_t m_XGenY1 = 0;
+static _Thread_local int32_t m_XGenY2 = 0;
+static _Thread_local int32_t m_BandY1 = 0;
+static _Thread_local int32_t m_BandY2 = 0;
 
 static void M_FlatA(
     GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface, int32_t y1,
@@ -116,12 +139,18 @@ static void M_TransA(
 static void M_GourA(
     GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface, int32_t y1,
     int32_t y2, uint8_t color_idx);
+static void M_MapA(
+    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface, int32_t y1,
+    int32_t y2, const uint8_t *tex_page, M_SPAN_FUNC span_func);
 static void M_GTMapA(
     GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface, int32_t y1,
     int32_t y2, const uint8_t *tex_page);
 static void M_WGTMapA(
     GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface, int32_t y1,
     int32_t y2, const uint8_t *tex_page);
+static void M_MapPersp32FP(
+    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface, int32_t y1,
+    int32_t y2, const uint8_t *tex_page, M_SPAN_FUNC span_func);
 static void M_GTMapPersp32FP(
     GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface, int32_t y1,
     int32_t y2, const uint8_t *tex_page);
@@ -161,6 +190,12 @@ static void M_DrawScaledSpriteC(
     const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
     GFX_2D_SURFACE *alpha_surface);
 
+static void M_GetPolyBounds(const int16_t *obj_ptr, int32_t *y1, int32_t *y2);
+static void M_CreateBands(M_PRIV *priv);
+static void M_FreeBands(M_PRIV *priv);
+static void M_BinPolys(M_PRIV *priv);
+static void M_DrawBand(void *arg, int32_t band_idx);
+
 static void M_InsertFlatFace3s(
     RENDERER *const renderer, const FACE3 *faces, int32_t num,
     SORT_TYPE sort_type);
@@ -250,21 +285,10 @@ static void M_TransA(
 
     while (y_size > 0) {
         const int32_t x = xbuf->x1 / PHD_ONE;
-        int32_t x_size = (xbuf->x2 / PHD_ONE) - x;
-        if (x_size <= 0) {
-            goto loop_end;
-        }
-
-        PIX_FMT *target_line_ptr = target_ptr + x;
-        ALPHA_FMT *alpha_line_ptr = alpha_ptr + x;
-        while (x_size > 0) {
-            *target_line_ptr = MAKE_PAL_IDX(map->index[*target_line_ptr]);
-            target_line_ptr++;
-            *alpha_line_ptr++ = 255;
-            x_size--;
+        const int32_t x_size = (xbuf->x2 / PHD_ONE) - x;
+        if (x_size > 0) {
+            SWR_Span_Trans(target_ptr + x, alpha_ptr + x, x_size, map);
         }
-
-    loop_end:
         y_size--;
         xbuf++;
         target_ptr += target_stride;
@@ -290,24 +314,14 @@ static void M_GourA(
 
     while (y_size > 0) {
         const int32_t x = xbuf->x1 / PHD_ONE;
-        int32_t x_size = (xbuf->x2 / PHD_ONE) - x;
-        if (x_size <= 0) {
-            goto loop_end;
-        }
-
-        int32_t g = xbuf->g1;
-        const int32_t g_add = (xbuf->g2 - g) / x_size;
-
-        PIX_FMT *target_line_ptr = target_ptr + x;
-        ALPHA_FMT *alpha_line_ptr = alpha_ptr + x;
-        while (x_size > 0) {
-            *target_line_ptr++ = MAKE_PAL_IDX(map->index[MAKE_Q_ID(g)]);
-            *alpha_line_ptr++ = 255;
-            g += g_add;
-            x_size--;
+        const int32_t x_size = (xbuf->x2 / PHD_ONE) - x;
+        if (x_size > 0) {
+            SWR_SPAN span = {
+                .g = xbuf->g1,
+                .g_add = (xbuf->g2 - xbuf->g1) / x_size,
+            };
+            SWR_Span_Gouraud(target_ptr + x, alpha_ptr + x, x_size, &span, map);
         }
-
-    loop_end:
         y_size--;
         xbuf++;
         target_ptr += target_stride;
@@ -315,9 +329,10 @@ static void M_GourA(
     }
 }
 
-static void M_GTMapA(
+static void M_MapA(
     GFX_2D_SURFACE *const alpha_surface, GFX_2D_SURFACE *const target_surface,
-    const int32_t y1, const int32_t y2, const uint8_t *const tex_page)
+    const int32_t y1, const int32_t y2, const uint8_t *const tex_page,
+    const M_SPAN_FUNC span_func)
 {
     int32_t y_size = y2 - y1;
     if (y_size <= 0) {
@@ -332,32 +347,19 @@ static void M_GTMapA(
 
     while (y_size > 0) {
         const int32_t x = xbuf->x1 / PHD_ONE;
-        int32_t x_size = (xbuf->x2 / PHD_ONE) - x;
-        if (x_size <= 0) {
-            goto loop_end;
-        }
-
-        int32_t g = xbuf->g1;
-        int32_t u = xbuf->u1;
-        int32_t v = xbuf->v1;
-        const int32_t g_add = (xbuf->g2 - g) / x_size;
-        const int32_t u_add = (xbuf->u2 - u) / x_size;
-        const int32_t v_add = (xbuf->v2 - v) / x_size;
-
-        PIX_FMT *target_line_ptr = target_ptr + x;
-        ALPHA_FMT *alpha_line_ptr = alpha_ptr + x;
-        while (x_size > 0) {
-            uint8_t color_idx = tex_page[MAKE_TEX_ID(v, u)];
-            *target_line_ptr++ = MAKE_PAL_IDX(
-                Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx]);
-            *alpha_line_ptr++ = 255;
-            g += g_add;
-            u += u_add;
-            v += v_add;
-            x_size--;
+        const int32_t x_size = (xbuf->x2 / PHD_ONE) - x;
+        if (x_size > 0) {
+            SWR_SPAN span = {
+                .g = xbuf->g1,
+                .u = xbuf->u1,
+                .v = xbuf->v1,
+                .g_add = (xbuf->g2 - xbuf->g1) / x_size,
+                .u_add = (xbuf->u2 - xbuf->u1) / x_size,
+                .v_add = (xbuf->v2 - xbuf->v1) / x_size,
+            };
+            span_func(
+                target_ptr + x, alpha_ptr + x, x_size, &span, tex_page, false);
         }
-
-    loop_end:
         y_size--;
         xbuf++;
         target_ptr += target_stride;
@@ -365,63 +367,26 @@ static void M_GTMapA(
     }
 }
 
+static void M_GTMapA(
+    GFX_2D_SURFACE *const alpha_surface, GFX_2D_SURFACE *const target_surface,
+    const int32_t y1, const int32_t y2, const uint8_t *const tex_page)
+{
+    M_MapA(alpha_surface, target_surface, y1, y2, tex_page, SWR_Span_GTMap);
+}
+
 static void M_WGTMapA(
     GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface,
     const int32_t y1, const int32_t y2, const uint8_t *tex_page)
 {
-    int32_t y_size = y2 - y1;
-    if (y_size <= 0) {
-        return;
-    }
-
-    const XBUF_XGUV *xbuf = (const XBUF_XGUV *)m_XBuffer + y1;
-    const int32_t target_stride = target_surface->desc.pitch;
-    const int32_t alpha_stride = alpha_surface->desc.pitch;
-    PIX_FMT *target_ptr = target_surface->buffer + y1 * target_stride;
-    ALPHA_FMT *alpha_ptr = alpha_surface->buffer + y1 * alpha_stride;
-
-    while (y_size > 0) {
-        const int32_t x = xbuf->x1 / PHD_ONE;
-        int32_t x_size = (xbuf->x2 / PHD_ONE) - x;
-        if (x_size <= 0) {
-            goto loop_end;
-        }
-
-        int32_t g = xbuf->g1;
-        int32_t u = xbuf->u1;
-        int32_t v = xbuf->v1;
-        const int32_t g_add = (xbuf->g2 - g) / x_size;
-        const int32_t u_add = (xbuf->u2 - u) / x_size;
-        const int32_t v_add = (xbuf->v2 - v) / x_size;
-
-        PIX_FMT *target_line_ptr = target_ptr + x;
-        ALPHA_FMT *alpha_line_ptr = alpha_ptr + x;
-        while (x_size > 0) {
-            const uint8_t color_idx = tex_page[MAKE_TEX_ID(v, u)];
-            if (color_idx != 0) {
-                *target_line_ptr = MAKE_PAL_IDX(
-                    Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx]);
-                *alpha_line_ptr = 255;
-            }
-            target_line_ptr++;
-            alpha_line_ptr++;
-            g += g_add;
-            u += u_add;
-            v += v_add;
-            x_size--;
-        }
-
-    loop_end:
-        y_size--;
-        xbuf++;
-        target_ptr += target_stride;
-        alpha_ptr += alpha_stride;
-    }
+    M_MapA(alpha_surface, target_surface, y1, y2, tex_page, SWR_Span_WGTMap);
 }
 
-static void M_GTMapPersp32FP(
-    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *const target_surface,
-    const int32_t y1, const int32_t y2, const uint8_t *const tex_page)
+// Perspective correct spans are split into affine batches of 32 pixels. When
+// the texture is magnified enough, each texel is drawn over two pixels.
+static void M_MapPersp32FP(
+    GFX_2D_SURFACE *const alpha_surface, GFX_2D_SURFACE *const target_surface,
+    const int32_t y1, const int32_t y2, const uint8_t *const tex_page,
+    const M_SPAN_FUNC span_func)
 {
     int32_t y_size = y2 - y1;
     if (y_size <= 0) {
@@ -441,15 +406,16 @@ static void M_GTMapPersp32FP(
             goto loop_end;
         }
 
-        int32_t g = xbuf->g1;
         double u = xbuf->u1;
         double v = xbuf->v1;
         double rhw = xbuf->rhw1;
 
-        const int32_t g_add = (xbuf->g2 - g) / x_size;
-
-        int32_t u0 = PHD_HALF * u / rhw;
-        int32_t v0 = PHD_HALF * v / rhw;
+        SWR_SPAN span = {
+            .g = xbuf->g1,
+            .u = PHD_HALF * u / rhw,
+            .v = PHD_HALF * v / rhw,
+            .g_add = (xbuf->g2 - xbuf->g1) / x_size,
+        };
 
         PIX_FMT *target_line_ptr = target_ptr + x;
         ALPHA_FMT *alpha_line_ptr = alpha_ptr + x;
@@ -471,39 +437,17 @@ static void M_GTMapPersp32FP(
                 const int32_t u1 = PHD_HALF * u / rhw;
                 const int32_t v1 = PHD_HALF * v / rhw;
 
-                const int32_t u0_add = (u1 - u0) / batch_size;
-                const int32_t v0_add = (v1 - v0) / batch_size;
-
-                if ((ABS(u0_add) + ABS(v0_add)) < (PHD_ONE / 2)) {
-                    int32_t batch_counter = batch_size / 2;
-                    while (batch_counter--) {
-                        const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                        const uint8_t color =
-                            Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-                        *target_line_ptr++ = MAKE_PAL_IDX(color);
-                        *target_line_ptr++ = MAKE_PAL_IDX(color);
-                        *alpha_line_ptr++ = 255;
-                        *alpha_line_ptr++ = 255;
-                        g += g_add * 2;
-                        u0 += u0_add * 2;
-                        v0 += v0_add * 2;
-                    }
-                } else {
-                    int32_t batch_counter = batch_size;
-                    while (batch_counter--) {
-                        const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                        const uint8_t color =
-                            Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-                        *target_line_ptr++ = MAKE_PAL_IDX(color);
-                        *alpha_line_ptr++ = 255;
-                        g += g_add;
-                        u0 += u0_add;
-                        v0 += v0_add;
-                    }
-                }
-
-                u0 = u1;
-                v0 = v1;
+                span.u_add = (u1 - span.u) / batch_size;
+                span.v_add = (v1 - span.v) / batch_size;
+                span_func(
+                    target_line_ptr, alpha_line_ptr, batch_size, &span,
+                    tex_page,
+                    (ABS(span.u_add) + ABS(span.v_add)) < (PHD_ONE / 2));
+                target_line_ptr += batch_size;
+                alpha_line_ptr += batch_size;
+
+                span.u = u1;
+                span.v = v1;
                 x_size -= batch_size;
             }
         }
@@ -511,47 +455,22 @@ static void M_GTMapPersp32FP(
         if (x_size > 1) {
             const int32_t u1 = PHD_HALF * xbuf->u2 / xbuf->rhw2;
             const int32_t v1 = PHD_HALF * xbuf->v2 / xbuf->rhw2;
-            const int32_t u0_add = (u1 - u0) / x_size;
-            const int32_t v0_add = (v1 - v0) / x_size;
+            span.u_add = (u1 - span.u) / x_size;
+            span.v_add = (v1 - span.v) / x_size;
 
             batch_size = x_size & ~1;
             x_size -= batch_size;
 
-            if ((ABS(u0_add) + ABS(v0_add)) < (PHD_ONE / 2)) {
-                int32_t batch_counter = batch_size / 2;
-                while (batch_counter--) {
-                    const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                    const uint8_t color =
-                        Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-                    *target_line_ptr++ = MAKE_PAL_IDX(color);
-                    *target_line_ptr++ = MAKE_PAL_IDX(color);
-                    *alpha_line_ptr++ = 255;
-                    *alpha_line_ptr++ = 255;
-                    g += g_add * 2;
-                    u0 += u0_add * 2;
-                    v0 += v0_add * 2;
-                }
-            } else {
-                int32_t batch_counter = batch_size;
-                while (batch_counter--) {
-                    const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                    const uint8_t color =
-                        Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-                    *target_line_ptr++ = MAKE_PAL_IDX(color);
-                    *alpha_line_ptr++ = 255;
-                    g += g_add;
-                    u0 += u0_add;
-                    v0 += v0_add;
-                }
-            }
+            span_func(
+                target_line_ptr, alpha_line_ptr, batch_size, &span, tex_page,
+                (ABS(span.u_add) + ABS(span.v_add)) < (PHD_ONE / 2));
+            target_line_ptr += batch_size;
+            alpha_line_ptr += batch_size;
         }
 
         if (x_size == 1) {
-            const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-            const uint8_t color =
-                Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-            *target_line_ptr = MAKE_PAL_IDX(color);
-            *alpha_line_ptr = 255;
+            span_func(
+                target_line_ptr, alpha_line_ptr, 1, &span, tex_page, false);
         }
 
     loop_end:
@@ -562,167 +481,20 @@ static void M_GTMapPersp32FP(
     }
 }
 
-static void M_WGTMapPersp32FP(
+static void M_GTMapPersp32FP(
     GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *const target_surface,
     const int32_t y1, const int32_t y2, const uint8_t *const tex_page)
 {
-    int32_t y_size = y2 - y1;
-    if (y_size <= 0) {
-        return;
-    }
-
-    const XBUF_XGUVP *xbuf = (const XBUF_XGUVP *)m_XBuffer + y1;
-    const int32_t target_stride = target_surface->desc.pitch;
-    const int32_t alpha_stride = alpha_surface->desc.pitch;
-    PIX_FMT *target_ptr = target_surface->buffer + y1 * target_stride;
-    ALPHA_FMT *alpha_ptr = alpha_surface->buffer + y1 * alpha_stride;
-
-    while (y_size > 0) {
-        const int32_t x = xbuf->x1 / PHD_ONE;
-        int32_t x_size = (xbuf->x2 / PHD_ONE) - x;
-        if (x_size <= 0) {
-            goto loop_end;
-        }
-
-        int32_t g = xbuf->g1;
-        double u = xbuf->u1;
-        double v = xbuf->v1;
-        double rhw = xbuf->rhw1;
-
-        const int32_t g_add = (xbuf->g2 - g) / x_size;
-
-        int32_t u0 = PHD_HALF * u / rhw;
-        int32_t v0 = PHD_HALF * v / rhw;
-
-        PIX_FMT *target_line_ptr = target_ptr + x;
-        ALPHA_FMT *alpha_line_ptr = alpha_ptr + x;
-        int32_t batch_size = 32;
-
-        if (x_size >= batch_size) {
-            const double u_add =
-                (xbuf->u2 - u) / (double)x_size * (double)batch_size;
-            const double v_add =
-                (xbuf->v2 - v) / (double)x_size * (double)batch_size;
-            const double rhw_add =
-                (xbuf->rhw2 - rhw) / (double)x_size * (double)batch_size;
-
-            while (x_size >= batch_size) {
-                u += u_add;
-                v += v_add;
-                rhw += rhw_add;
-
-                const int32_t u1 = PHD_HALF * u / rhw;
-                const int32_t v1 = PHD_HALF * v / rhw;
-
-                const int32_t u0_add = (u1 - u0) / batch_size;
-                const int32_t v0_add = (v1 - v0) / batch_size;
-
-                if ((ABS(u0_add) + ABS(v0_add)) < (PHD_ONE / 2)) {
-                    int32_t batch_counter = batch_size / 2;
-                    while (batch_counter--) {
-                        const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                        if (color_idx != 0) {
-                            const uint8_t color =
-                                Output_GetLightMap(MAKE_Q_ID(g))
-                                    ->index[color_idx];
-                            target_line_ptr[0] = MAKE_PAL_IDX(color);
-                            target_line_ptr[1] = MAKE_PAL_IDX(color);
-                            alpha_line_ptr[0] = 255;
-                            alpha_line_ptr[1] = 255;
-                        }
-                        target_line_ptr += 2;
-                        alpha_line_ptr += 2;
-                        g += g_add * 2;
-                        u0 += u0_add * 2;
-                        v0 += v0_add * 2;
-                    }
-                } else {
-                    int32_t batch_counter = batch_size;
-                    while (batch_counter--) {
-                        const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                        if (color_idx != 0) {
-                            const uint8_t color =
-                                Output_GetLightMap(MAKE_Q_ID(g))
-                                    ->index[color_idx];
-                            *target_line_ptr = MAKE_PAL_IDX(color);
-                            *alpha_line_ptr = 255;
-                        }
-                        target_line_ptr++;
-                        alpha_line_ptr++;
-                        g += g_add;
-                        u0 += u0_add;
-                        v0 += v0_add;
-                    }
-                }
-
-                u0 = u1;
-                v0 = v1;
-                x_size -= batch_size;
-            }
-        }
-
-        if (x_size > 1) {
-            const int32_t u1 = PHD_HALF * xbuf->u2 / xbuf->rhw2;
-            const int32_t v1 = PHD_HALF * xbuf->v2 / xbuf->rhw2;
-            const int32_t u0_add = (u1 - u0) / x_size;
-            const int32_t v0_add = (v1 - v0) / x_size;
-
-            batch_size = x_size & ~1;
-            x_size -= batch_size;
-
-            if ((ABS(u0_add) + ABS(v0_add)) < (PHD_ONE / 2)) {
-                int32_t batch_counter = batch_size / 2;
-                while (batch_counter--) {
-                    const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                    if (color_idx != 0) {
-                        const uint8_t color =
-                            Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-                        target_line_ptr[0] = MAKE_PAL_IDX(color);
-                        target_line_ptr[1] = MAKE_PAL_IDX(color);
-                        alpha_line_ptr[0] = 255;
-                        alpha_line_ptr[1] = 255;
-                    }
-                    target_line_ptr += 2;
-                    alpha_line_ptr += 2;
-                    g += g_add * 2;
-                    u0 += u0_add * 2;
-                    v0 += v0_add * 2;
-                };
-            } else {
-                int32_t batch_counter = batch_size;
-                while (batch_counter--) {
-                    const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                    if (color_idx != 0) {
-                        const uint8_t color =
-                            Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-                        *target_line_ptr = MAKE_PAL_IDX(color);
-                        *alpha_line_ptr = 255;
-                    }
-                    target_line_ptr++;
-                    alpha_line_ptr++;
-                    g += g_add;
-                    u0 += u0_add;
-                    v0 += v0_add;
-                }
-            }
-        }
-
-        if (x_size == 1) {
-            const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-            if (color_idx != 0) {
-                const uint8_t color =
-                    Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-                *target_line_ptr = MAKE_PAL_IDX(color);
-                *alpha_line_ptr = 255;
-            }
-        }
+    M_MapPersp32FP(
+        alpha_surface, target_surface, y1, y2, tex_page, SWR_Span_GTMap);
+}
 
-    loop_end:
-        y_size--;
-        xbuf++;
-        target_ptr += target_stride;
-        alpha_ptr += alpha_stride;
-    }
+static void M_WGTMapPersp32FP(
+    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *const target_surface,
+    const int32_t y1, const int32_t y2, const uint8_t *const tex_page)
+{
+    M_MapPersp32FP(
+        alpha_surface, target_surface, y1, y2, tex_page, SWR_Span_WGTMap);
 }
 
 static bool M_XGenX(const int16_t *obj_ptr)
@@ -772,13 +544,9 @@ static bool M_XGenX(const int16_t *obj_ptr)
         }
     }
 
-    if (y_min == y_max) {
-        return false;
-    }
-
-    m_XGenY1 = y_min;
-    m_XGenY2 = y_max;
-    return true;
+    m_XGenY1 = MAX(y_min, m_BandY1);
+    m_XGenY2 = MIN(y_max, m_BandY2);
+    return m_XGenY1 < m_XGenY2;
 }
 
 static bool M_XGenXG(const int16_t *obj_ptr)
@@ -840,13 +608,9 @@ static bool M_XGenXG(const int16_t *obj_ptr)
         }
     }
 
-    if (y_min == y_max) {
-        return false;
-    }
-
-    m_XGenY1 = y_min;
-    m_XGenY2 = y_max;
-    return true;
+    m_XGenY1 = MAX(y_min, m_BandY1);
+    m_XGenY2 = MIN(y_max, m_BandY2);
+    return m_XGenY1 < m_XGenY2;
 }
 
 static bool M_XGenXGUV(const int16_t *obj_ptr)
@@ -932,13 +696,9 @@ static bool M_XGenXGUV(const int16_t *obj_ptr)
         }
     }
 
-    if (y_min == y_max) {
-        return false;
-    }
-
-    m_XGenY1 = y_min;
-    m_XGenY2 = y_max;
-    return true;
+    m_XGenY1 = MAX(y_min, m_BandY1);
+    m_XGenY2 = MIN(y_max, m_BandY2);
+    return m_XGenY1 < m_XGenY2;
 }
 
 static bool M_XGenXGUVPerspFP(const int16_t *obj_ptr)
@@ -1038,13 +798,9 @@ static bool M_XGenXGUVPerspFP(const int16_t *obj_ptr)
         }
     }
 
-    if (y_min == y_max) {
-        return false;
-    }
-
-    m_XGenY1 = y_min;
-    m_XGenY2 = y_max;
-    return true;
+    m_XGenY1 = MAX(y_min, m_BandY1);
+    m_XGenY2 = MIN(y_max, m_BandY2);
+    return m_XGenY1 < m_XGenY2;
 }
 
 static void M_DrawPolyFlat(
@@ -1173,9 +929,15 @@ static void M_DrawPolyLine(
     int32_t y_size = y2 - y1;
     PIX_FMT *target_ptr = &target_surface->buffer[x1 + target_stride * y1];
     ALPHA_FMT *alpha_ptr = &alpha_surface->buffer[x1 + target_stride * y1];
+    const PIX_FMT *const band_start =
+        &target_surface->buffer[target_stride * m_BandY1];
+    const PIX_FMT *const band_end =
+        &target_surface->buffer[target_stride * m_BandY2];
 
     if (!x_size && !y_size) {
-        *target_ptr = lcolor;
+        if (target_ptr >= band_start && target_ptr < band_end) {
+            *target_ptr = lcolor;
+        }
         //*alpha_ptr = 255;
         return;
     }
@@ -1216,7 +978,9 @@ static void M_DrawPolyLine(
     int32_t part = PHD_ONE * rows / cols;
     for (int32_t i = 0; i < cols; i++) {
         part_sum += part;
-        *target_ptr = lcolor;
+        if (target_ptr >= band_start && target_ptr < band_end) {
+            *target_ptr = lcolor;
+        }
         target_ptr += col_add;
         //*alpha_ptr = 255;
         // alpha_ptr += col_add;
@@ -1262,6 +1026,14 @@ static void M_DrawScaledSpriteC(
     }
     CLAMPG(x1, g_PhdWinMaxX + 1);
     CLAMPG(y1, g_PhdWinMaxY + 1);
+    if (y0 < m_BandY1) {
+        v_base += (m_BandY1 - y0) * v_add;
+        y0 = m_BandY1;
+    }
+    CLAMPG(y1, m_BandY2);
+    if (y0 >= y1) {
+        return;
+    }
 
     const int32_t target_stride = target_surface->desc.pitch;
     const int32_t width = x1 - x0;
@@ -1294,12 +1066,148 @@ static void M_DrawScaledSpriteC(
     }
 }
 
+static void M_GetPolyBounds(
+    const int16_t *obj_ptr, int32_t *const y1, int32_t *const y2)
+{
+    const int16_t poly_type = *obj_ptr++;
+    int32_t stride;
+    switch (poly_type) {
+    case POLY_LINE:
+    case POLY_SPRITE:
+        *y1 = MIN(obj_ptr[1], obj_ptr[3]);
+        *y2 = MAX(obj_ptr[1], obj_ptr[3]);
+        return;
+
+    case POLY_GTMAP:
+    case POLY_WGTMAP:
+        stride = sizeof(XGEN_XGUV) / sizeof(int16_t);
+        break;
+
+    case POLY_GTMAP_PERSP:
+    case POLY_WGTMAP_PERSP:
+        stride = sizeof(XGEN_XGUVP) / sizeof(int16_t);
+        break;
+
+    case POLY_GOURAUD:
+        stride = sizeof(XGEN_XG) / sizeof(int16_t);
+        break;
+
+    default:
+        stride = sizeof(XGEN_X) / sizeof(int16_t);
+        break;
+    }
+
+    // All of the XGEN point layouts start with x and y.
+    const int32_t pt_count = obj_ptr[1];
+    const int16_t *pt = &obj_ptr[2];
+    *y1 = pt[1];
+    *y2 = pt[1];
+    for (int32_t i = 1; i < pt_count; i++) {
+        pt += stride;
+        CLAMPG(*y1, pt[1]);
+        CLAMPL(*y2, pt[1]);
+    }
+}
+
+static void M_CreateBands(M_PRIV *const priv)
+{
+    const int32_t height = g_PhdWinHeight;
+    int32_t band_count = 1;
+    if (ThreadPool_GetThreadCount(priv->thread_pool) > 1) {
+        band_count = MIN(
+            ThreadPool_GetThreadCount(priv->thread_pool) * BANDS_PER_THREAD,
+            height / MIN_BAND_HEIGHT);
+        CLAMPL(band_count, 1);
+    }
+    const int32_t band_height = (height + band_count - 1) / band_count;
+    band_count = (height + band_height - 1) / band_height;
+
+    priv->band_count = band_count;
+    priv->band_capacity = 0;
+    priv->bands = Memory_Alloc(sizeof(M_BAND) * band_count);
+    for (int32_t i = 0; i < band_count; i++) {
+        M_BAND *const band = &priv->bands[i];
+        band->y1 = i * band_height;
+        band->y2 = MIN((i + 1) * band_height, height);
+        band->x_buffer = Memory_Alloc(sizeof(XBUF_XGUVP) * height);
+    }
+}
+
+static void M_FreeBands(M_PRIV *const priv)
+{
+    for (int32_t i = 0; i < priv->band_count; i++) {
+        Memory_FreePointer(&priv->bands[i].x_buffer);
+        Memory_FreePointer(&priv->bands[i].polys);
+    }
+    Memory_FreePointer(&priv->bands);
+    priv->band_count = 0;
+    priv->band_capacity = 0;
+}
+
+static void M_BinPolys(M_PRIV *const priv)
+{
+    if (priv->band_capacity < g_SurfaceCount) {
+        priv->band_capacity = g_SurfaceCount;
+        for (int32_t i = 0; i < priv->band_count; i++) {
+            priv->bands[i].polys = Memory_Realloc(
+                priv->bands[i].polys, sizeof(int32_t) * priv->band_capacity);
+        }
+    }
+
+    for (int32_t i = 0; i < priv->band_count; i++) {
+        priv->bands[i].poly_count = 0;
+    }
+
+    if (priv->band_count == 1) {
+        M_BAND *const band = &priv->bands[0];
+        for (int32_t i = 0; i < g_SurfaceCount; i++) {
+            band->polys[band->poly_count++] = i;
+        }
+        return;
+    }
+
+    // The sort buffer is already in painter's order, so appending keeps each
+    // band's list in that order too.
+    const int32_t band_height = priv->bands[0].y2 - priv->bands[0].y1;
+    for (int32_t i = 0; i < g_SurfaceCount; i++) {
+        int32_t y1;
+        int32_t y2;
+        M_GetPolyBounds((const int16_t *)g_SortBuffer[i]._0, &y1, &y2);
+        int32_t band1 = y1 / band_height;
+        int32_t band2 = y2 / band_height;
+        CLAMP(band1, 0, priv->band_count - 1);
+        CLAMP(band2, 0, priv->band_count - 1);
+        for (int32_t j = band1; j <= band2; j++) {
+            M_BAND *const band = &priv->bands[j];
+            band->polys[band->poly_count++] = i;
+        }
+    }
+}
+
+static void M_DrawBand(void *const arg, const int32_t band_idx)
+{
+    M_PRIV *const priv = arg;
+    const M_BAND *const band = &priv->bands[band_idx];
+    m_XBuffer = band->x_buffer;
+    m_BandY1 = band->y1;
+    m_BandY2 = band->y2;
+
+    for (int32_t i = 0; i < band->poly_count; i++) {
+        const int16_t *obj_ptr =
+            (const int16_t *)g_SortBuffer[band->polys[i]]._0;
+        const int16_t poly_type = *obj_ptr++;
+        m_PolyDrawRoutines[poly_type](
+            obj_ptr, priv->surface, priv->surface_alpha);
+    }
+}
+
 static void M_Init(RENDERER *const renderer)
 {
     M_PRIV *const priv = Memory_Alloc(sizeof(M_PRIV));
     priv->renderer_2d = GFX_2D_Renderer_Create();
     renderer->priv = priv;
     renderer->initialized = true;
+    SWR_Span_Init();
 }
 
 static void M_Open(RENDERER *const renderer)
@@ -1310,7 +1218,10 @@ static void M_Open(RENDERER *const renderer)
         return;
     }
 
-    m_XBuffer = Memory_Realloc(m_XBuffer, sizeof(XBUF_XGUVP) * g_PhdWinHeight);
+    if (priv->thread_pool == nullptr) {
+        priv->thread_pool = ThreadPool_Create("swr", -1);
+    }
+    M_CreateBands(priv);
 
     {
         GFX_2D_Surface_Free(priv->surface);
@@ -1349,7 +1260,7 @@ static void M_Close(RENDERER *const renderer)
         return;
     }
 
-    Memory_FreePointer(&m_XBuffer);
+    M_FreeBands(priv);
 
     if (priv->surface != nullptr) {
         GFX_2D_Surface_Free(priv->surface);
@@ -1374,6 +1285,10 @@ static void M_Shutdown(RENDERER *const renderer)
         GFX_2D_Renderer_Destroy(priv->renderer_2d);
         priv->renderer_2d = nullptr;
     }
+    if (priv->thread_pool != nullptr) {
+        ThreadPool_Free(priv->thread_pool);
+        priv->thread_pool = nullptr;
+    }
     renderer->initialized = false;
 }
 
@@ -1423,12 +1338,8 @@ static void M_DrawPolyList(RENDERER *const renderer)
 
     Render_SortPolyList();
 
-    for (int32_t i = 0; i < g_SurfaceCount; i++) {
-        const int16_t *obj_ptr = (const int16_t *)g_SortBuffer[i]._0;
-        const int16_t poly_type = *obj_ptr++;
-        m_PolyDrawRoutines[poly_type](
-            obj_ptr, priv->surface, priv->surface_alpha);
-    }
+    M_BinPolys(priv);
+    ThreadPool_Run(priv->thread_pool, priv->band_count, M_DrawBand, priv);
 
     GFX_2D_Renderer_UploadSurface(priv->renderer_2d, priv->surface);
     GFX_2D_Renderer_UploadAlphaSurface(priv->renderer_2d, priv->surface_alpha);
@@ -0,0 +1,578 @@
+#include "game/render/swr_span.h"
+
+#include "game/output.h"
+#include "global/const.h"
+
+#include <libtrx/log.h>
+
+#include <SDL2/SDL_cpuinfo.h>
+#include <string.h>
+
+#define MAKE_Q_ID(g) ((g >> 16) & 0xFF)
+#define MAKE_TEX_ID(v, u) ((((v >> 16) & 0xFF) << 8) | ((u >> 16) & 0xFF))
+
+// The vectorised spans are written with the GCC/Clang vector extensions and
+// compiled for the baseline instruction set (SSE2 on x86-64, NEON on AArch64).
+// On x86 an AVX2 variant is picked at runtime, which also replaces the texel
+// and light map lookups with hardware gathers.
+#define M_LANES 16
+#define M_FORCE_INLINE inline __attribute__((always_inline))
+#if defined(__x86_64__) || defined(__i386__)
+    #define M_HAS_AVX2
+    #define M_TARGET_AVX2 __attribute__((target("avx2")))
+    #include <immintrin.h>
+#endif
+
+typedef uint32_t M_U32X16 __attribute__((vector_size(M_LANES * 4)));
+typedef uint8_t M_U8X16 __attribute__((vector_size(M_LANES)));
+
+typedef struct {
+    const char *name;
+    void (*gouraud)(
+        uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+        const SHADE_MAP *map);
+    void (*trans)(
+        uint8_t *target, uint8_t *alpha, int32_t count, const LIGHT_MAP *map);
+    void (*gt_map)(
+        uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+        const uint8_t *tex_page, bool is_doubled);
+    void (*wgt_map)(
+        uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+        const uint8_t *tex_page, bool is_doubled);
+} M_FUNCS;
+
+static const M_U32X16 m_LaneIndex = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+};
+
+static M_FORCE_INLINE void M_ScalarTextured(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const uint8_t *tex_page, bool is_doubled, bool is_transparent);
+static M_FORCE_INLINE void M_StoreSpan(
+    uint8_t *target, uint8_t *alpha, const uint8_t *colors,
+    const uint8_t *mask, bool is_transparent);
+static M_FORCE_INLINE void M_VectorGouraud(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const SHADE_MAP *map);
+static M_FORCE_INLINE void M_VectorTrans(
+    uint8_t *target, uint8_t *alpha, int32_t count, const LIGHT_MAP *map);
+static M_FORCE_INLINE void M_VectorTextured(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const uint8_t *tex_page, bool is_doubled, bool is_transparent);
+
+static void M_Scalar_Gouraud(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const SHADE_MAP *map);
+static void M_Scalar_Trans(
+    uint8_t *target, uint8_t *alpha, int32_t count, const LIGHT_MAP *map);
+static void M_Scalar_GTMap(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const uint8_t *tex_page, bool is_doubled);
+static void M_Scalar_WGTMap(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const uint8_t *tex_page, bool is_doubled);
+
+static void M_Vector_Gouraud(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const SHADE_MAP *map);
+static void M_Vector_Trans(
+    uint8_t *target, uint8_t *alpha, int32_t count, const LIGHT_MAP *map);
+static void M_Vector_GTMap(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const uint8_t *tex_page, bool is_doubled);
+static void M_Vector_WGTMap(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const uint8_t *tex_page, bool is_doubled);
+
+#ifdef M_HAS_AVX2
+M_TARGET_AVX2 static M_FORCE_INLINE __m256i M_AVX2Gather8(
+    const uint8_t *base, __m256i idx, int32_t size);
+M_TARGET_AVX2 static M_FORCE_INLINE __m128i M_AVX2Pack8(__m256i value);
+M_TARGET_AVX2 static M_FORCE_INLINE void M_AVX2Textured(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const uint8_t *tex_page, bool is_doubled, bool is_transparent);
+
+M_TARGET_AVX2 static void M_AVX2_Gouraud(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const SHADE_MAP *map);
+M_TARGET_AVX2 static void M_AVX2_Trans(
+    uint8_t *target, uint8_t *alpha, int32_t count, const LIGHT_MAP *map);
+M_TARGET_AVX2 static void M_AVX2_GTMap(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const uint8_t *tex_page, bool is_doubled);
+M_TARGET_AVX2 static void M_AVX2_WGTMap(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const uint8_t *tex_page, bool is_doubled);
+#endif
+
+static const M_FUNCS m_ScalarFuncs = {
+    .name = "scalar",
+    .gouraud = M_Scalar_Gouraud,
+    .trans = M_Scalar_Trans,
+    .gt_map = M_Scalar_GTMap,
+    .wgt_map = M_Scalar_WGTMap,
+};
+
+static const M_FUNCS m_VectorFuncs = {
+#if defined(__aarch64__) || defined(__ARM_NEON)
+    .name = "NEON",
+#else
+    .name = "SSE2",
+#endif
+    .gouraud = M_Vector_Gouraud,
+    .trans = M_Vector_Trans,
+    .gt_map = M_Vector_GTMap,
+    .wgt_map = M_Vector_WGTMap,
+};
+
+#ifdef M_HAS_AVX2
+static const M_FUNCS m_AVX2Funcs = {
+    .name = "AVX2",
+    .gouraud = M_AVX2_Gouraud,
+    .trans = M_AVX2_Trans,
+    .gt_map = M_AVX2_GTMap,
+    .wgt_map = M_AVX2_WGTMap,
+};
+#endif
+
+static const M_FUNCS *m_Funcs = &m_ScalarFuncs;
+
+static M_FORCE_INLINE void M_ScalarTextured(
+    uint8_t *target, uint8_t *alpha, const int32_t count, SWR_SPAN *const span,
+    const uint8_t *const tex_page, const bool is_doubled,
+    const bool is_transparent)
+{
+    const int32_t step = is_doubled ? 2 : 1;
+    const int32_t g_add = span->g_add * step;
+    const int32_t u_add = span->u_add * step;
+    const int32_t v_add = span->v_add * step;
+    int32_t g = span->g;
+    int32_t u = span->u;
+    int32_t v = span->v;
+
+    for (int32_t i = 0; i < count; i += step) {
+        const uint8_t color_idx = tex_page[MAKE_TEX_ID(v, u)];
+        if (!is_transparent || color_idx != 0) {
+            const uint8_t color =
+                Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
+            for (int32_t j = 0; j < step; j++) {
+                target[j] = color;
+                alpha[j] = 255;
+            }
+        }
+        target += step;
+        alpha += step;
+        g += g_add;
+        u += u_add;
+        v += v_add;
+    }
+
+    span->g = g;
+    span->u = u;
+    span->v = v;
+}
+
+static M_FORCE_INLINE void M_StoreSpan(
+    uint8_t *const target, uint8_t *const alpha, const uint8_t *const colors,
+    const uint8_t *const mask, const bool is_transparent)
+{
+    if (!is_transparent) {
+        memcpy(target, colors, M_LANES);
+        memset(alpha, 255, M_LANES);
+        return;
+    }
+
+    M_U8X16 target_vec;
+    M_U8X16 alpha_vec;
+    M_U8X16 colors_vec;
+    M_U8X16 mask_vec;
+    memcpy(&target_vec, target, M_LANES);
+    memcpy(&alpha_vec, alpha, M_LANES);
+    memcpy(&colors_vec, colors, M_LANES);
+    memcpy(&mask_vec, mask, M_LANES);
+    target_vec = (target_vec & ~mask_vec) | (colors_vec & mask_vec);
+    alpha_vec |= mask_vec;
+    memcpy(target, &target_vec, M_LANES);
+    memcpy(alpha, &alpha_vec, M_LANES);
+}
+
+static M_FORCE_INLINE void M_VectorGouraud(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *const span,
+    const SHADE_MAP *const map)
+{
+    const uint32_t g_add = span->g_add;
+    M_U32X16 g = (uint32_t)span->g + m_LaneIndex * g_add;
+
+    while (count >= M_LANES) {
+        const M_U32X16 q_id = (g >> 16) & 0xFF;
+        uint8_t colors[M_LANES];
+        for (int32_t i = 0; i < M_LANES; i++) {
+            colors[i] = map->index[q_id[i]];
+        }
+        M_StoreSpan(target, alpha, colors, nullptr, false);
+        target += M_LANES;
+        alpha += M_LANES;
+        g += g_add * M_LANES;
+        count -= M_LANES;
+    }
+
+    span->g = g[0];
+    M_Scalar_Gouraud(target, alpha, count, span, map);
+}
+
+static M_FORCE_INLINE void M_VectorTrans(
+    uint8_t *target, uint8_t *alpha, int32_t count, const LIGHT_MAP *const map)
+{
+    while (count >= M_LANES) {
+        uint8_t colors[M_LANES];
+        for (int32_t i = 0; i < M_LANES; i++) {
+            colors[i] = map->index[target[i]];
+        }
+        M_StoreSpan(target, alpha, colors, nullptr, false);
+        target += M_LANES;
+        alpha += M_LANES;
+        count -= M_LANES;
+    }
+
+    M_Scalar_Trans(target, alpha, count, map);
+}
+
+static M_FORCE_INLINE void M_VectorTextured(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *const span,
+    const uint8_t *const tex_page, const bool is_doubled,
+    const bool is_transparent)
+{
+    // Bypass Output_GetLightMap in the inner loop; the light maps are stored
+    // contiguously.
+    const LIGHT_MAP *const light_maps = Output_GetLightMap(0);
+    const int32_t step = is_doubled ? 2 : 1;
+    const uint32_t g_add = span->g_add * step;
+    const uint32_t u_add = span->u_add * step;
+    const uint32_t v_add = span->v_add * step;
+    M_U32X16 g = (uint32_t)span->g + m_LaneIndex * g_add;
+    M_U32X16 u = (uint32_t)span->u + m_LaneIndex * u_add;
+    M_U32X16 v = (uint32_t)span->v + m_LaneIndex * v_add;
+
+    while (count >= M_LANES * step) {
+        // Spilling the indices is cheaper than extracting each lane.
+        uint32_t tex_id[M_LANES];
+        uint32_t q_id[M_LANES];
+        const M_U32X16 tex_id_vec = ((v >> 8) & 0xFF00) | ((u >> 16) & 0xFF);
+        const M_U32X16 q_id_vec = (g >> 16) & 0xFF;
+        memcpy(tex_id, &tex_id_vec, sizeof(tex_id));
+        memcpy(q_id, &q_id_vec, sizeof(q_id));
+
+        uint8_t colors[M_LANES];
+        uint8_t mask[M_LANES];
+        for (int32_t i = 0; i < M_LANES; i++) {
+            const uint8_t color_idx = tex_page[tex_id[i]];
+            colors[i] = light_maps[q_id[i]].index[color_idx];
+            mask[i] = color_idx != 0 ? 0xFF : 0;
+        }
+
+        if (is_doubled) {
+            uint8_t colors2[M_LANES * 2];
+            uint8_t mask2[M_LANES * 2];
+            for (int32_t i = 0; i < M_LANES; i++) {
+                colors2[i * 2] = colors2[i * 2 + 1] = colors[i];
+                mask2[i * 2] = mask2[i * 2 + 1] = mask[i];
+            }
+            M_StoreSpan(target, alpha, colors2, mask2, is_transparent);
+            M_StoreSpan(
+                target + M_LANES, alpha + M_LANES, colors2 + M_LANES,
+                mask2 + M_LANES, is_transparent);
+        } else {
+            M_StoreSpan(target, alpha, colors, mask, is_transparent);
+        }
+
+        target += M_LANES * step;
+        alpha += M_LANES * step;
+        g += g_add * M_LANES;
+        u += u_add * M_LANES;
+        v += v_add * M_LANES;
+        count -= M_LANES * step;
+    }
+
+    span->g = g[0];
+    span->u = u[0];
+    span->v = v[0];
+    M_ScalarTextured(
+        target, alpha, count, span, tex_page, is_doubled, is_transparent);
+}
+
+static void M_Scalar_Gouraud(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *const span,
+    const SHADE_MAP *const map)
+{
+    int32_t g = span->g;
+    while (count > 0) {
+        *target++ = map->index[MAKE_Q_ID(g)];
+        *alpha++ = 255;
+        g += span->g_add;
+        count--;
+    }
+    span->g = g;
+}
+
+static void M_Scalar_Trans(
+    uint8_t *target, uint8_t *alpha, int32_t count, const LIGHT_MAP *const map)
+{
+    while (count > 0) {
+        *target = map->index[*target];
+        target++;
+        *alpha++ = 255;
+        count--;
+    }
+}
+
+static void M_Scalar_GTMap(
+    uint8_t *const target, uint8_t *const alpha, const int32_t count,
+    SWR_SPAN *const span, const uint8_t *const tex_page, const bool is_doubled)
+{
+    M_ScalarTextured(target, alpha, count, span, tex_page, is_doubled, false);
+}
+
+static void M_Scalar_WGTMap(
+    uint8_t *const target, uint8_t *const alpha, const int32_t count,
+    SWR_SPAN *const span, const uint8_t *const tex_page, const bool is_doubled)
+{
+    M_ScalarTextured(target, alpha, count, span, tex_page, is_doubled, true);
+}
+
+static void M_Vector_Gouraud(
+    uint8_t *const target, uint8_t *const alpha, const int32_t count,
+    SWR_SPAN *const span, const SHADE_MAP *const map)
+{
+    M_VectorGouraud(target, alpha, count, span, map);
+}
+
+static void M_Vector_Trans(
+    uint8_t *const target, uint8_t *const alpha, const int32_t count,
+    const LIGHT_MAP *const map)
+{
+    M_VectorTrans(target, alpha, count, map);
+}
+
+static void M_Vector_GTMap(
+    uint8_t *const target, uint8_t *const alpha, const int32_t count,
+    SWR_SPAN *const span, const uint8_t *const tex_page, const bool is_doubled)
+{
+    if (is_doubled) {
+        M_VectorTextured(target, alpha, count, span, tex_page, true, false);
+    } else {
+        M_VectorTextured(target, alpha, count, span, tex_page, false, false);
+    }
+}
+
+static void M_Vector_WGTMap(
+    uint8_t *const target, uint8_t *const alpha, const int32_t count,
+    SWR_SPAN *const span, const uint8_t *const tex_page, const bool is_doubled)
+{
+    if (is_doubled) {
+        M_VectorTextured(target, alpha, count, span, tex_page, true, true);
+    } else {
+        M_VectorTextured(target, alpha, count, span, tex_page, false, true);
+    }
+}
+
+#ifdef M_HAS_AVX2
+// Gathers single bytes using dword gathers. Indices too close to the end of
+// the table are moved back and the value is shifted down instead, so that the
+// gather never reads past the table.
+M_TARGET_AVX2 static M_FORCE_INLINE __m256i M_AVX2Gather8(
+    const uint8_t *const base, const __m256i idx, const int32_t size)
+{
+    const __m256i excess = _mm256_max_epi32(
+        _mm256_sub_epi32(idx, _mm256_set1_epi32(size - 4)),
+        _mm256_setzero_si256());
+    const __m256i words = _mm256_i32gather_epi32(
+        (const int *)base, _mm256_sub_epi32(idx, excess), 1);
+    return _mm256_and_si256(
+        _mm256_srlv_epi32(words, _mm256_slli_epi32(excess, 3)),
+        _mm256_set1_epi32(0xFF));
+}
+
+// Packs the low bytes of eight dwords into the low half of the result.
+M_TARGET_AVX2 static M_FORCE_INLINE __m128i M_AVX2Pack8(const __m256i value)
+{
+    const __m256i shuffle = _mm256_setr_epi8(
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, //
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i packed = _mm256_permutevar8x32_epi32(
+        _mm256_shuffle_epi8(value, shuffle),
+        _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1));
+    return _mm256_castsi256_si128(packed);
+}
+
+M_TARGET_AVX2 static M_FORCE_INLINE void M_AVX2Textured(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *const span,
+    const uint8_t *const tex_page, const bool is_doubled,
+    const bool is_transparent)
+{
+    const uint8_t *const light_maps = Output_GetLightMap(0)->index;
+    const int32_t step = is_doubled ? 2 : 1;
+    const int32_t g_add = span->g_add * step;
+    const int32_t u_add = span->u_add * step;
+    const int32_t v_add = span->v_add * step;
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i g = _mm256_add_epi32(
+        _mm256_set1_epi32(span->g),
+        _mm256_mullo_epi32(lane, _mm256_set1_epi32(g_add)));
+    __m256i u = _mm256_add_epi32(
+        _mm256_set1_epi32(span->u),
+        _mm256_mullo_epi32(lane, _mm256_set1_epi32(u_add)));
+    __m256i v = _mm256_add_epi32(
+        _mm256_set1_epi32(span->v),
+        _mm256_mullo_epi32(lane, _mm256_set1_epi32(v_add)));
+    const __m256i g_step = _mm256_set1_epi32(g_add * 8);
+    const __m256i u_step = _mm256_set1_epi32(u_add * 8);
+    const __m256i v_step = _mm256_set1_epi32(v_add * 8);
+    const __m256i mask_hi = _mm256_set1_epi32(0xFF00);
+    const __m256i mask_lo = _mm256_set1_epi32(0xFF);
+
+    while (count >= 8 * step) {
+        const __m256i tex_id = _mm256_or_si256(
+            _mm256_and_si256(_mm256_srli_epi32(v, 8), mask_hi),
+            _mm256_and_si256(_mm256_srli_epi32(u, 16), mask_lo));
+        const __m256i color_idx =
+            M_AVX2Gather8(tex_page, tex_id, TEXTURE_PAGE_SIZE);
+        const __m256i light_id = _mm256_or_si256(
+            _mm256_and_si256(_mm256_srli_epi32(g, 8), mask_hi), color_idx);
+        const __m256i color = M_AVX2Gather8(
+            light_maps, light_id, LIGHT_MAP_SIZE * sizeof(LIGHT_MAP));
+
+        __m128i colors = M_AVX2Pack8(color);
+        __m128i mask = M_AVX2Pack8(
+            _mm256_cmpeq_epi32(color_idx, _mm256_setzero_si256()));
+        mask = _mm_xor_si128(mask, _mm_set1_epi8(-1));
+        if (is_doubled) {
+            colors = _mm_unpacklo_epi8(colors, colors);
+            mask = _mm_unpacklo_epi8(mask, mask);
+            if (is_transparent) {
+                const __m128i old_target =
+                    _mm_loadu_si128((const __m128i *)target);
+                const __m128i old_alpha =
+                    _mm_loadu_si128((const __m128i *)alpha);
+                colors = _mm_blendv_epi8(old_target, colors, mask);
+                mask = _mm_or_si128(old_alpha, mask);
+            } else {
+                mask = _mm_set1_epi8(-1);
+            }
+            _mm_storeu_si128((__m128i *)target, colors);
+            _mm_storeu_si128((__m128i *)alpha, mask);
+        } else {
+            if (is_transparent) {
+                const __m128i old_target =
+                    _mm_loadl_epi64((const __m128i *)target);
+                const __m128i old_alpha =
+                    _mm_loadl_epi64((const __m128i *)alpha);
+                colors = _mm_blendv_epi8(old_target, colors, mask);
+                mask = _mm_or_si128(old_alpha, mask);
+            } else {
+                mask = _mm_set1_epi8(-1);
+            }
+            _mm_storel_epi64((__m128i *)target, colors);
+            _mm_storel_epi64((__m128i *)alpha, mask);
+        }
+
+        target += 8 * step;
+        alpha += 8 * step;
+        g = _mm256_add_epi32(g, g_step);
+        u = _mm256_add_epi32(u, u_step);
+        v = _mm256_add_epi32(v, v_step);
+        count -= 8 * step;
+    }
+
+    span->g = _mm256_extract_epi32(g, 0);
+    span->u = _mm256_extract_epi32(u, 0);
+    span->v = _mm256_extract_epi32(v, 0);
+    M_ScalarTextured(
+        target, alpha, count, span, tex_page, is_doubled, is_transparent);
+}
+
+M_TARGET_AVX2 static void M_AVX2_Gouraud(
+    uint8_t *const target, uint8_t *const alpha, const int32_t count,
+    SWR_SPAN *const span, const SHADE_MAP *const map)
+{
+    M_VectorGouraud(target, alpha, count, span, map);
+}
+
+M_TARGET_AVX2 static void M_AVX2_Trans(
+    uint8_t *const target, uint8_t *const alpha, const int32_t count,
+    const LIGHT_MAP *const map)
+{
+    M_VectorTrans(target, alpha, count, map);
+}
+
+M_TARGET_AVX2 static void M_AVX2_GTMap(
+    uint8_t *const target, uint8_t *const alpha, const int32_t count,
+    SWR_SPAN *const span, const uint8_t *const tex_page, const bool is_doubled)
+{
+    if (is_doubled) {
+        M_AVX2Textured(target, alpha, count, span, tex_page, true, false);
+    } else {
+        M_AVX2Textured(target, alpha, count, span, tex_page, false, false);
+    }
+}
+
+M_TARGET_AVX2 static void M_AVX2_WGTMap(
+    uint8_t *const target, uint8_t *const alpha, const int32_t count,
+    SWR_SPAN *const span, const uint8_t *const tex_page, const bool is_doubled)
+{
+    if (is_doubled) {
+        M_AVX2Textured(target, alpha, count, span, tex_page, true, true);
+    } else {
+        M_AVX2Textured(target, alpha, count, span, tex_page, false, true);
+    }
+}
+#endif
+
+void SWR_Span_Init(void)
+{
+    m_Funcs = &m_ScalarFuncs;
+#ifdef M_HAS_AVX2
+    if (SDL_HasAVX2()) {
+        m_Funcs = &m_AVX2Funcs;
+    } else if (SDL_HasSSE2()) {
+        m_Funcs = &m_VectorFuncs;
+    }
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+    if (SDL_HasNEON()) {
+        m_Funcs = &m_VectorFuncs;
+    }
+#endif
+    LOG_INFO("Using %s span functions", m_Funcs->name);
+}
+
+const char *SWR_Span_GetName(void)
+{
+    return m_Funcs->name;
+}
+
+void SWR_Span_Gouraud(
+    uint8_t *const target, uint8_t *const alpha, const int32_t count,
+    SWR_SPAN *const span, const SHADE_MAP *const map)
+{
+    m_Funcs->gouraud(target, alpha, count, span, map);
+}
+
+void SWR_Span_Trans(
+    uint8_t *const target, uint8_t *const alpha, const int32_t count,
+    const LIGHT_MAP *const map)
+{
+    m_Funcs->trans(target, alpha, count, map);
+}
+
+void SWR_Span_GTMap(
+    uint8_t *const target, uint8_t *const alpha, const int32_t count,
+    SWR_SPAN *const span, const uint8_t *const tex_page, const bool is_doubled)
+{
+    m_Funcs->gt_map(target, alpha, count, span, tex_page, is_doubled);
+}
+
+void SWR_Span_WGTMap(
+    uint8_t *const target, uint8_t *const alpha, const int32_t count,
+    SWR_SPAN *const span, const uint8_t *const tex_page, const bool is_doubled)
+{
+    m_Funcs->wgt_map(target, alpha, count, span, tex_page, is_doubled);
+}
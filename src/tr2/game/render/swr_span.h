@@ -0,0 +1,35 @@
+#pragma once
+
+#include <libtrx/game/output/types.h>
+
+#include <stdint.h>
+
+// Interpolants of a single affine span in 16.16 fixed point, stepped once per
+// pixel. The span functions advance them past the pixels they fill.
+typedef struct {
+    int32_t g;
+    int32_t u;
+    int32_t v;
+    int32_t g_add;
+    int32_t u_add;
+    int32_t v_add;
+} SWR_SPAN;
+
+// Picks the fastest span implementation supported by the CPU. The scalar
+// implementation is kept as the reference for the vectorised ones.
+void SWR_Span_Init(void);
+const char *SWR_Span_GetName(void);
+
+void SWR_Span_Gouraud(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const SHADE_MAP *map);
+void SWR_Span_Trans(
+    uint8_t *target, uint8_t *alpha, int32_t count, const LIGHT_MAP *map);
+
+// In doubled mode every texel covers two pixels and count must be even.
+void SWR_Span_GTMap(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const uint8_t *tex_page, bool is_doubled);
+void SWR_Span_WGTMap(
+    uint8_t *target, uint8_t *alpha, int32_t count, SWR_SPAN *span,
+    const uint8_t *tex_page, bool is_doubled);
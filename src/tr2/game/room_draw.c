@@ -6,6 +6,7 @@
 #include "game/output.h"
 #include "global/vars.h"
 
+#include <libtrx/benchmark.h>
 #include <libtrx/game/matrix.h>
 #include <libtrx/utils.h>
 
@@ -457,6 +458,7 @@ void Room_DrawSingleRoomObjects(const int16_t room_num)
 
 void Room_DrawAllRooms(const int16_t current_room)
 {
+    Benchmark_BeginZone(BENCHMARK_ZONE_DRAW_ROOMS);
     ROOM *const room = Room_Get(current_room);
     room->test_left = 0;
     room->test_top = 0;
@@ -538,4 +540,5 @@ void Room_DrawAllRooms(const int16_t current_room)
     }
 
     Output_SetupAboveWater(false);
+    Benchmark_EndZone(BENCHMARK_ZONE_DRAW_ROOMS);
 }
@@ -359,7 +359,8 @@ void Shell_Main(void)
 
     GameBuf_Init();
 
-    GF_COMMAND gf_cmd = GF_DoFrontendSequence();
+    GF_COMMAND gf_cmd = Demo_Benchmark_IsActive() ? Demo_Benchmark_Run()
+                                                  : GF_DoFrontendSequence();
     bool loop_continue = !Shell_IsExiting();
     while (loop_continue) {
         LOG_INFO(
@@ -428,7 +429,9 @@ void Shell_Main(void)
         }
     }
 
-    Config_Write();
+    if (!Demo_Benchmark_IsActive()) {
+        Config_Write();
+    }
 }
 
 void Shell_Shutdown(void)
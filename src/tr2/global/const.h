@@ -28,6 +28,7 @@
 #define MAX_AUDIO_SAMPLE_TRACKS 32
 #define MAX_PALETTES 16
 #define MAX_VERTICES 0x2000
+#define MAX_SORT_ITEMS 4000
 #define MAX_BOUND_ROOMS 128
 #define MAX_EFFECTS 100
 #define MAX_LEVELS 24
@@ -25,7 +25,7 @@ int32_t g_PhdWinHeight;
 int32_t g_PhdWinCenterX;
 int32_t g_PhdWinCenterY;
 float g_FltWinTop;
-SORT_ITEM g_SortBuffer[4000];
+SORT_ITEM g_SortBuffer[MAX_SORT_ITEMS];
 float g_FltWinLeft;
 int32_t g_PhdFarZ;
 float g_FltRhwOPersp;
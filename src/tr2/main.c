@@ -1,4 +1,5 @@
 #include "decomp/decomp.h"
+#include "game/demo.h"
 #include "game/shell.h"
 #include "global/vars.h"
 
@@ -12,6 +13,7 @@ int main(int argc, char **argv)
     Log_Init(log_path);
     Memory_Free(log_path);
 
+    Demo_Benchmark_ParseArgs(argc, argv);
     Shell_Setup();
     Shell_Main();
     Shell_Terminate(0);